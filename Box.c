@@ -0,0 +1,210 @@
+#include "Joystick.h"
+
+// Where the cursor is on the box screen, and its mode.
+static uint8_t cursorRow;
+static uint8_t cursorCol;
+static BoxMode_t cursorMode;
+
+// Column mask of each box in the box map, and its partial column.
+static uint8_t boxMap[MAP_BOXES];
+static uint8_t partialBox;
+static uint8_t partialCol;
+static uint8_t partialEggs;
+
+// Positions the cursor passes through going down a box column, counting the
+// box name, and going across, counting the party.
+#define ROW_RING    (BOX_ROWS + 1)
+#define COLUMN_RING (BOX_COLUMNS + 1)
+
+// Eggs the box map has in column col of box box, from the top down.
+static uint8_t boxMapEggs(uint8_t box, uint8_t col) {
+	if (box >= MAP_BOXES || !(boxMap[box] & (1 << col)))
+		return 0;
+	if (partialEggs && box == partialBox && col == partialCol)
+		return partialEggs;
+	return BOX_ROWS;
+}
+
+// Tap a direction or button a number of times.
+static void press(Buttons_t button, uint8_t times) {
+	command move = {button, 8};
+	command gap = {NOTHING, 15};
+	while (times--) {
+		runCommand(move);
+		runCommand(gap);
+	}
+}
+
+// Step from one position of a ring to another, whichever way is shorter.
+static void stepRing(uint8_t from, uint8_t to, uint8_t size, Buttons_t forward, Buttons_t back) {
+	uint8_t ahead = (to + size - from) % size;
+	if (ahead <= size - ahead)
+		press(forward, ahead);
+	else
+		press(back, size - ahead);
+}
+
+// Hold A on the top of count pokemon and drag down to the last of them.
+static void grab(uint8_t count) {
+	command a = {A, 8};
+	command down = {DOWN, 8};
+	command gap = {NOTHING, 8};
+	if (count == 0)
+		return;
+
+	PROFILE_ENTER(PHASE_SELECT);
+	runCommand(a);
+	runCommand(gap);
+	while (count-- > 1) {
+		runCommand(down);
+		runCommand(gap);
+	}
+	runCommand(a);
+	runCommand(gap);
+	PROFILE_EXIT(PHASE_SELECT);
+}
+
+void openBox() {
+	PROFILE_ENTER(PHASE_OPEN_BOX);
+	runSequenceId(SEQ_OPEN_BOX);
+	PROFILE_EXIT(PHASE_OPEN_BOX);
+	cursorRow = 0;
+	cursorCol = 0;
+	cursorMode = BOX_MULTISELECT;
+}
+
+void openBoxNormal() {
+	PROFILE_ENTER(PHASE_OPEN_BOX);
+	runSequenceId(SEQ_OPEN_BOX_NORMAL);
+	PROFILE_EXIT(PHASE_OPEN_BOX);
+	cursorRow = 0;
+	cursorCol = 0;
+	cursorMode = BOX_NORMAL;
+}
+
+void boxUseMode(BoxMode_t mode) {
+	if (mode == cursorMode)
+		return;
+	PROFILE_ENTER(PHASE_SELECT);
+	press(Y, (mode + NUM_BOX_MODES - cursorMode) % NUM_BOX_MODES);
+	PROFILE_EXIT(PHASE_SELECT);
+	cursorMode = mode;
+}
+
+void boxMoveTo(uint8_t row, uint8_t col) {
+	PROFILE_ENTER(PHASE_MOVE_CURSOR);
+	if (cursorCol == BOX_PARTY && col == BOX_PARTY) {
+		// The party doesn't wrap.
+		if (row > cursorRow)
+			press(DOWN, row - cursorRow);
+		else
+			press(UP, cursorRow - row);
+	} else if (cursorCol == BOX_PARTY) {
+		stepRing(cursorCol, col, COLUMN_RING, RIGHT, LEFT);
+		if (cursorRow >= BOX_ROWS)
+			cursorRow = BOX_ROWS - 1;
+		stepRing(cursorRow, row, ROW_RING, DOWN, UP);
+	} else {
+		// Line the row up first; moving sideways on the box name would
+		// switch boxes. The last party slot is below the last row.
+		uint8_t boxRow = row < BOX_ROWS ? row : BOX_ROWS - 1;
+		stepRing(cursorRow, boxRow, ROW_RING, DOWN, UP);
+		stepRing(cursorCol, col, COLUMN_RING, RIGHT, LEFT);
+		press(DOWN, row - boxRow);
+	}
+	cursorRow = row;
+	cursorCol = col;
+	PROFILE_EXIT(PHASE_MOVE_CURSOR);
+}
+
+void selectColumn() {
+	boxUseMode(BOX_MULTISELECT);
+	grab(BOX_ROWS);
+}
+
+void boxColumnToParty(uint8_t col) {
+	boxMoveTo(0, col);
+	selectColumn();
+	boxMoveTo(1, BOX_PARTY);
+	press(A, 1);
+}
+
+void boxPartyToColumn(uint8_t col, uint8_t count) {
+	// With nothing picked up, A would pick up whatever is at col instead.
+	if (count == 0)
+		return;
+
+	boxMoveTo(1, BOX_PARTY);
+	boxUseMode(BOX_MULTISELECT);
+	grab(count);
+	boxMoveTo(0, col);
+	press(A, 1);
+}
+
+void boxReleaseStart(uint8_t row, uint8_t col) {
+	PROFILE_ENTER(PHASE_RELEASE_SLOT);
+	boxMoveTo(row, col);
+	boxUseMode(BOX_NORMAL);
+	runSequenceId(SEQ_RELEASE);
+}
+
+void boxReleaseEnd(void) {
+	runSequenceId(SEQ_RELEASE_DIALOGUE);
+	PROFILE_EXIT(PHASE_RELEASE_SLOT);
+}
+
+void boxRelease(uint8_t row, uint8_t col) {
+	boxReleaseStart(row, col);
+	boxReleaseEnd();
+}
+
+void boxReleaseColumn(uint8_t box, uint8_t col, uint8_t keep) {
+	uint8_t rows = boxMapEggs(box, col);
+	uint8_t row;
+	for (row = 0; row < rows; row++) {
+		if (!(keep & (1 << row)))
+			boxRelease(row, col);
+	}
+}
+
+void boxNextBox() {
+	PROFILE_ENTER(PHASE_NEXT_BOX);
+	press(R, 1);
+	PROFILE_EXIT(PHASE_NEXT_BOX);
+}
+
+void boxPrevBox() {
+	PROFILE_ENTER(PHASE_NEXT_BOX);
+	press(L, 1);
+	PROFILE_EXIT(PHASE_NEXT_BOX);
+}
+
+void boxMapFill(uint8_t boxes, uint8_t columns) {
+	uint8_t box;
+	if (boxes > MAP_BOXES)
+		boxes = MAP_BOXES;
+	for (box = 0; box < boxes; box++)
+		boxMap[box] |= columns;
+}
+
+void boxMapAdd(uint8_t box, uint8_t col, uint8_t eggs) {
+	if (box >= MAP_BOXES || eggs == 0)
+		return;
+	boxMap[box] |= 1 << col;
+	if (eggs < BOX_ROWS) {
+		partialBox = box;
+		partialCol = col;
+		partialEggs = eggs;
+	}
+}
+
+uint8_t boxMapNext(uint8_t* box, uint8_t* col) {
+	for (; *box < MAP_BOXES; (*box)++, *col = 0) {
+		for (; *col < BOX_COLUMNS; (*col)++) {
+			uint8_t eggs = boxMapEggs(*box, *col);
+			if (eggs)
+				return eggs;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef _BOX_H_
+#define _BOX_H_
+
+// Includes
+#include <stdint.h>
+
+// The box screen is a grid of BOX_ROWS by BOX_COLUMNS, with the party shown
+// as one more column to its left. Moving left off the first column or right
+// off the last wraps around through the party, and moving up or down off the
+// grid wraps around through the box name above it. From the party, the
+// cursor moves across to the same row of the box, or its last row.
+// L and R switch boxes without moving the cursor, and picking up a column
+// with multiselect leaves the cursor at its top.
+#define BOX_ROWS    5
+#define BOX_COLUMNS 6
+#define PARTY_SIZE  6
+// Column number of the party.
+#define BOX_PARTY   BOX_COLUMNS
+// Boxes in the PC, and so in the box map.
+#define MAP_BOXES   32
+
+// Cursor modes of the box screen, in the order Y cycles through them. The
+// PC opens in BOX_NORMAL.
+typedef enum {
+	BOX_NORMAL,
+	BOX_MULTIPURPOSE,
+	BOX_MULTISELECT,
+	NUM_BOX_MODES
+} BoxMode_t;
+
+// Function Prototypes
+// Open the box in "multiselect" mode, where an entire column of pokemon can
+// be moved at once, with the cursor at 0, 0. Assumes menu is over "Pokemon".
+void openBox(void);
+// Open the box in the normal mode, where "A" opens the menu of a pokemon.
+void openBoxNormal(void);
+// Switch the cursor to mode with Y.
+void boxUseMode(BoxMode_t mode);
+// Move the cursor to row, col in the fewest presses.
+void boxMoveTo(uint8_t row, uint8_t col);
+// Pick up the column of 5 below the cursor.
+void selectColumn(void);
+// Move the column at col into the party behind the lead.
+void boxColumnToParty(uint8_t col);
+// Move the count pokemon behind the lead to the top of the column at col.
+void boxPartyToColumn(uint8_t col, uint8_t count);
+// Release the pokemon at row, col: boxReleaseStart() up to the press that
+// confirms it, after which it is gone, and boxReleaseEnd() through the
+// dialogues that follow.
+void boxRelease(uint8_t row, uint8_t col);
+void boxReleaseStart(uint8_t row, uint8_t col);
+void boxReleaseEnd(void);
+// Release the pokemon hatched from the eggs the box map has in column col of
+// box box, from the top down, except the rows set in keep. The PC must show
+// that box. Rows the map has no egg in are empty and left alone, as the
+// release inputs would move the cursor off an empty slot.
+void boxReleaseColumn(uint8_t box, uint8_t col, uint8_t keep);
+// Switch to the next or previous box.
+void boxNextBox(void);
+void boxPrevBox(void);
+
+// The box map records which columns hold eggs, counting boxes from the one
+// the job started on. A column holds BOX_ROWS eggs from the top down, apart
+// from a single partial column, as left by the last column of a collection.
+// Mark the columns set in columns as full in each of the first boxes boxes.
+void boxMapFill(uint8_t boxes, uint8_t columns);
+// Mark column col of box box as holding eggs eggs.
+void boxMapAdd(uint8_t box, uint8_t col, uint8_t eggs);
+// Move box and col on to the first column at or after them that holds eggs,
+// and return its eggs, or 0 if there are none left.
+uint8_t boxMapNext(uint8_t* box, uint8_t* col);
+
+#endif
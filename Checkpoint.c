@@ -0,0 +1,74 @@
+#include "Joystick.h"
+
+#include <stddef.h>
+#include <util/crc16.h>
+
+Checkpoint_t checkpoint;
+// Ring slot of checkpoint, or CHECKPOINT_SLOTS if there is none yet.
+static uint8_t slot = CHECKPOINT_SLOTS;
+
+static uint8_t crc8(const uint8_t* data, uint8_t length) {
+	uint8_t crc = 0;
+	while (length--)
+		crc = _crc_ibutton_update(crc, *data++);
+	return crc;
+}
+
+// CRC of the parameters that decide what a job does.
+static uint8_t jobId(void) {
+	uint8_t job[] = {
+		CFG_MODE, CFG_EGGS & 0xFF, CFG_EGGS >> 8, CFG_BOXES,
+		CFG_RELEASE_BOXES, CFG_HATCH_COLUMNS
+	};
+	return crc8(job, sizeof(job));
+}
+
+// Read the slot at i, returning whether it holds a valid checkpoint.
+static bool readSlot(uint8_t i, Checkpoint_t* cp) {
+	eeprom_read_block(cp, (const void*)(CHECKPOINT_ADDRESS + i * sizeof(Checkpoint_t)), sizeof(Checkpoint_t));
+	return cp->crc == crc8((const uint8_t*)cp, offsetof(Checkpoint_t, crc));
+}
+
+bool loadCheckpoint(void) {
+	Checkpoint_t cp, next;
+	bool valid, nextValid;
+	uint8_t i;
+
+	valid = readSlot(CHECKPOINT_SLOTS - 1, &cp);
+	for (i = 0; i < CHECKPOINT_SLOTS; i++) {
+		nextValid = readSlot(i, &next);
+		// The newest checkpoint is the one the chain of writes stops at.
+		if (valid && !(nextValid && next.seq == (uint8_t)(cp.seq + 1))) {
+			checkpoint = cp;
+			slot = (i + CHECKPOINT_SLOTS - 1) % CHECKPOINT_SLOTS;
+			break;
+		}
+		cp = next;
+		valid = nextValid;
+	}
+
+	return slot < CHECKPOINT_SLOTS && checkpoint.job == jobId() && checkpoint.phase != CHECKPOINT_NONE;
+}
+
+void saveCheckpoint(CheckpointPhase_t phase, uint16_t count, uint8_t box, uint8_t col) {
+	// Only what the game has been sent counts as done, so let everything
+	// queued play out first.
+	flushCommands();
+	if (slot < CHECKPOINT_SLOTS) {
+		checkpoint.seq++;
+		slot = (slot + 1) % CHECKPOINT_SLOTS;
+	} else {
+		checkpoint.seq = 0;
+		slot = 0;
+	}
+	checkpoint.job   = jobId();
+	checkpoint.phase = phase;
+	checkpoint.count = count;
+	checkpoint.box   = box;
+	checkpoint.col   = col;
+	checkpoint.crc   = crc8((const uint8_t*)&checkpoint, offsetof(Checkpoint_t, crc));
+
+	// The main loop stalls for the few ms per byte this takes, while reports
+	// keep going out from the interrupt.
+	eeprom_update_block(&checkpoint, (void*)(CHECKPOINT_ADDRESS + slot * sizeof(Checkpoint_t)), sizeof(Checkpoint_t));
+}
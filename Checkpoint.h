@@ -0,0 +1,63 @@
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <avr/eeprom.h>
+
+// Type Defines
+// Where a job had got to. Each phase is a point where the game is back in the
+// overworld, or can be backed out to it with B, so that the job can carry on
+// from there after the controller has been reset.
+typedef enum {
+	// No job in progress, or the last one finished.
+	CHECKPOINT_NONE,
+	// count eggs have been collected, the last col of them still in the
+	// party and the rest stored.
+	CHECKPOINT_COLLECT,
+	// Hatching is about to start, on the first box with an empty party.
+	CHECKPOINT_HATCH_START,
+	// The party holds the eggs of column col of box box, not yet walked.
+	CHECKPOINT_HATCH,
+	// count eggs have been taken in COLLECT_AND_HATCH.
+	CHECKPOINT_PIPELINE,
+	// The first count slots of box box, in the order release() visits them,
+	// have been released, and the PC shows that box.
+	CHECKPOINT_RELEASE
+} CheckpointPhase_t;
+
+// A checkpoint as written to EEPROM. The checkpoints go round a ring of
+// CHECKPOINT_SLOTS slots, so that each slot is only written every
+// CHECKPOINT_SLOTS checkpoints. seq goes up by one with every write; the
+// newest checkpoint is the valid one not followed by its successor.
+typedef struct {
+	uint8_t  seq;
+	// CRC-8 of the job parameters, so that a checkpoint is never resumed
+	// into a different job.
+	uint8_t  job;
+	uint16_t count;
+	uint8_t  phase;          // CheckpointPhase_t
+	uint8_t  box;
+	uint8_t  col;
+	// CRC-8 (Dallas/iButton) of every byte above.
+	uint8_t  crc;
+} Checkpoint_t;
+
+// EEPROM address of the ring, just past the parameter block, and its slots.
+// eepconfig.py blanks the ring, so writing new settings starts a new job.
+#define CHECKPOINT_ADDRESS 32
+#define CHECKPOINT_SLOTS   16
+
+extern Checkpoint_t checkpoint;
+
+// Function Prototypes
+// Load the newest checkpoint of the current job into checkpoint. Returns true
+// if there is one to resume from.
+bool loadCheckpoint(void);
+// Write a checkpoint to the next slot of the ring, once everything queued has
+// been played.
+void saveCheckpoint(CheckpointPhase_t phase, uint16_t count, uint8_t box, uint8_t col);
+
+#endif
@@ -1,1158 +1,1097 @@
-/*
-Nintendo Switch Fightstick - Proof-of-Concept
-
-Based on the LUFA library's Low-Level Joystick Demo
-	(C) Dean Camera
-Based on the HORI's Pokken Tournament Pro Pad design
-	(C) HORI
-
-This project implements a modified version of HORI's Pokken Tournament Pro Pad
-USB descriptors to allow for the creation of custom controllers for the
-Nintendo Switch. This also works to a limited degree on the PS3.
-
-Since System Update v3.0.0, the Nintendo Switch recognizes the Pokken
-Tournament Pro Pad as a Pro Controller. Physical design limitations prevent
-the Pokken Controller from functioning at the same level as the Pro
-Controller. However, by default most of the descriptors are there, with the
-exception of Home and Capture. Descriptor modification allows us to unlock
-these buttons for our use.
-*/
-
-// make && sudo dfu-programmer atmega16u2 erase && sudo dfu-programmer atmega16u2 flash Joystick.hex
-
-// make && ./teensy_loader_cli -mmcu=atmega32u4 -w Joystick.hex
-
-#include "Joystick.h"
-#include <time.h>
-#include <stdio.h>
-
-#define ECHOES 2
-int echoes = 0;
-USB_JoystickReport_Input_t last_report;
-
-int report_count = 0;
-int xpos = 0;
-int ypos = 0;
-int duration_count = 0;
-int portsval = 0;
-int collectCycle = 0;
-int numReleased = 0;
-int boxCycle = 0;
-int baseeggstepmult = 2;
-
-bool boxOpened = false;
-
-typedef enum {
-	COLLECTING,
-	COLLECT_THEN_HATCH,
-	HATCHING,
-	RELEASING,
-	RAIDRESETTING,
-	FLY
-} Modes;
-
-Modes mode = HATCHING;
-int numBoxes = 4;
-// Separate globals are used across COLLECTING and HATCHING modes to make them
-// individually configurable. When using COLLECT_THEN_HATCH, the hatching
-// params will be overridden by the collecting params (overcoming all those
-// sneaky human errors in keeping the numbers consistent).
-
-// Globals used during COLLECTING.
-int eggsToCollect = 30;
-int boxesForward = 0;
-// When putting eggs away in COLLECTING mode, we need to keep track of
-// where in the box we are. Since nothing is multi-threaded, this is relatively
-// safe.
-// currentRow will be 0-4, and currentColumn 0-5.
-// note to self: if we grab 5 at a time, we don't have to care about row
-// TODO: Change collect() to accept row & col to place.
-// TODO: Change collect() to return the next row & col & bool for moving to the
-// next box.
-int currentRow = 0;
-int currentColumn = 0;
-// Globals used during HATCHING.
-// We hatch in columns, which are 5 eggs at a time.
-// If using COLLECT_THEN_HATCH, these are overridden to comply with
-// COLLECTING args.
-// The remainder of eggs (eggsToCollect % 30) won't be hatched.
-int boxesToHatch = 8;
-
-static const command sync[] = {
-	// Setup controller
-	{ NOTHING,  250 },
-	{ TRIGGERS,   5 },
-	{ NOTHING,  100 },
-	{ TRIGGERS,   5 },
-	{ NOTHING,  100 },
-	{ A,          5 },
-	{ NOTHING,   50 }
-};
-
-static const command run[] = {
-	{ LEFT,     80},
-	{ NOTHING,  5},
-	{ RIGHT,    70},
-	{ NOTHING,  5},
-	{ UPRIGHT,  40},
-	{ NOTHING,  10}
-};
-
-
-// Assumes menu is already over "Pokemon"
-static const command openPC[] = {
-	{X, 5},
-	{NOTHING, 45},
-	{A, 5},
-	{NOTHING, 70},
-	{R, 5},
-	{NOTHING, 70},
-	// Puts in "multipurpose" select mode
-	{Y, 5},
-	{NOTHING, 5},
-	// Puts in "multiselect" select mode
-	{Y, 5},
-	{NOTHING, 5}
-};
-
-//Note move to the correct column first
-static const command grabColumn[] = {
-	{A, 5},
-	{NOTHING, 5},
-	{DOWN, 5},
-	{NOTHING, 5},
-	{DOWN, 5},
-	{NOTHING, 5},
-	{DOWN, 5},
-	{NOTHING, 5},
-	{DOWN, 5},
-	{NOTHING, 5},
-	{A, 5},
-	{NOTHING, 5}
-};
-//Allows drops column after
-
-static const command spin[] = {
-	//20 cycle
-	{SPIN, 2800}
-	//40 cycle
-	//{SPIN, 4900}
-};
-
-//move left a certain number of times first if needed
-static const command movePokemon[] = {
-	//Move left
-	{LEFT, 5},
-	{NOTHING, 5},
-
-	//Move right
-	{RIGHT, 5},
-	{NOTHING, 5},
-
-	//Places eggs down
-	{DOWN, 5},
-	{NOTHING, 5},
-	{A, 5},
-	{NOTHING, 5}
-};
-
-static const command release[] = {
-	//Release pokemon
-	//a
-	{A, 5},
-	{NOTHING, 10},
-	//up
-	{UP, 5},
-	{NOTHING, 5},
-	//up
-	{UP, 5},
-	{NOTHING, 5},
-	//a
-	{A, 5},
-	{NOTHING, 40},
-	//up0
-	{UP, 5},
-	{NOTHING, 5},
-	//a
-	{A, 5},
-	{NOTHING, 65},
-	{A, 5},
-	{NOTHING, 40},
-};
-
-static const command bMovement[] = {
-	{UP, 5},
-	{RIGHT, 5},
-	{DOWN, 5},
-	{LEFT, 5}
-};
-
-static const command nothing[] = {
-	{NOTHING, 5},
-	{NOTHING, 10},
-	{NOTHING, 20},
-	{NOTHING, 30},
-	{NOTHING, 40},
-};
-
-static const command buttons[] = {
-	{HOME, 5},
-	{A, 5},
-	{B, 5},
-	{X, 5},
-	{Y, 5}
-};
-
-// Main entry point.
-int main(void) {
-	// We'll start by performing hardware and peripheral setup.
-	SetupHardware();
-	// We'll then enable global interrupts for our use.
-	GlobalInterruptEnable();
-	bool setup = true;
-	if (setup) {
-		command temp = {TRIGGERS, 50};
-		runCommand(temp);
-		command temp2 = {NOTHING, 5};
-		runCommand(temp2);
-		command temp3 = {A, 50};
-		runCommand(temp3);
-		setup = false;
-		if (mode == COLLECTING || mode == COLLECT_THEN_HATCH) {
-			command temp4 = { UPRIGHT,    140};
-			runCommand(temp4);
-		}
-		if (mode == COLLECT_THEN_HATCH) {
-			// Init the args to hatch().
-			boxesToHatch = eggsToCollect / 5;
-		}
-	}
-	if (mode == COLLECTING || mode == COLLECT_THEN_HATCH) {
-		int i;
-		for (i = 0; i < eggsToCollect; i++) {
-			collect();
-		}
-	}
-	// We moved forward in the box during egg collecting.
-	// So we have to move back to the box we started at in the PC.
-	if (mode == COLLECT_THEN_HATCH) {
-		openBoxMultipurpose();
-
-		command doUp = {UP, 5};
-		command doNothing = {NOTHING, 10};
-		command doLeft = {LEFT, 5};
-
-		runCommand(doUp);
-		runCommand(doNothing);
-		int i;
-		for (i = 0; i < boxesForward; i++) {
-			runCommand(doLeft);
-			runCommand(doNothing);
-		}
-
-		// Mash B to exit the box.
-		int b;
-		for (b = 0; b < 13; b++) {
-			command b1 = {B, 15};
-			runCommand(b1);
-			command b2 = {NOTHING, 5};
-			runCommand(b2);
-		}
-	}
-	if (mode == COLLECT_THEN_HATCH || mode == HATCHING) {
-		int i;
-		for (i = 0; i < boxesToHatch; i++) {
-			hatch();
-			// Move to the next box.
-			openBox();
-			command doNothing = {NOTHING, 10};
-			command doUp = {UP, 5};
-			command doRight = {RIGHT, 5};
-			command doB = {B, 5};
-
-			runCommand(doUp);
-			runCommand(doNothing);
-			runCommand(doRight);
-			runCommand(doNothing);
-
-			// Mash b to exit the box.
-			int b;
-			for (b = 0; b < 13; b++) {
-				runCommand(doB);
-				runCommand(doNothing);
-			}
-		}
-	}
-/*
-	if(mode == FLY) {
-		runCommand(buttons[3]);  // x
-		runCommand(nothing[20]);
-		runCommand(buttons[1]);  // a
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[2]);
-
-		command a1 = {DOWN, 6};
-		runCommand(a1);
-		runCommand(nothing[1]);
-		command a2 = {RIGHT, 10};
-		runCommand(a2);
-		runCommand(buttons[1]);  // a
-		runCommand(nothing[3]);
-		runCommand(buttons[1]);  // a
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		command a3 = {PLUS, 5};
-		runCommand(a3);
-		runCommand(nothing[1]);
-		command a4 = {RIGHT, 300};
-		runCommand(a4);
-		command a5 = {L, 5};
-		runCommand(a5);
-		// Move from map to pokemon box?
-		runCommand(buttons[3]); // x
-		runCommand(nothing[20]);
-		runCommand(bMovement[0]);  // UP
-		runCommand(bMovement[1]);  // RIGHT
-		runCommand(buttons[2]);  // B
-		runCommand(nothing[2]);
-		putPokemonAway(1);
-		command a6 = {R, 5};
-		runCommand(a6);
-		int b;
-		for (b = 0; b < 18; b++) {
-			command b1 = {B, 15};
-			runCommand(b1);
-			command b2 = {NOTHING, 5};
-			runCommand(b2);
-		}
-		mode = HATCHING;
-	}
-
-	if (mode == HATCHING) {
-		int i = 0;
-		for (i = 0; i < 11; i++) {
-			hatch();
-		}
-	}
-
-	if (mode == RELEASING) {
-		//open box
-		int i;
-		for (i = 0; i < numBoxes; i++) {
-			if (boxOpened == false) {
-				runCommand(openPC[0]);
-				runCommand(openPC[1]);
-				runCommand(openPC[2]);
-				runCommand(openPC[3]);
-				runCommand(openPC[4]);
-				runCommand(openPC[5]);
-				boxOpened = true;
-			}
-			int col;
-			for (col = 0; col < 6; col++) {
-				int row;
-				for (row = 0; row < 5; row++) {
-					//release
-					runCommand(release[0]);
-					runCommand(release[1]);
-					runCommand(release[2]);
-					runCommand(release[3]);
-					runCommand(release[4]);
-					runCommand(release[5]);
-					runCommand(release[6]);
-					runCommand(release[7]);
-					runCommand(release[8]);
-					runCommand(release[9]);
-					runCommand(release[10]);
-					runCommand(release[11]);
-					runCommand(release[12]);
-					runCommand(release[13]);
-					//go down
-
-					runCommand(movePokemon[4]);
-					runCommand(movePokemon[5]);
-				}
-				//go back to top and move over
-					runCommand(movePokemon[4]);
-					runCommand(movePokemon[5]);
-					runCommand(movePokemon[4]);
-					runCommand(movePokemon[5]);
-					runCommand(movePokemon[2]);
-					runCommand(movePokemon[3]);
-			}
-			//Nextbox:
-			command NextBox = {R, 5};
-			command pause = {NOTHING, 5};
-			runCommand(movePokemon[2]);
-			runCommand(movePokemon[3]);
-			runCommand(NextBox);
-			runCommand(pause);
-		}
-	}
-
-//a, a, a, a(wait 30), home
-//on home menu: down, right, right, right, right, a
-//Hold down for a fair amount of time lets say 40?
-//a, down, down, down, down, a
-//down, down, a
-//right, up, right, right, right, right, right, a, home, home, b(15), a, long wait (70)
-	if (mode == RAIDRESETTING) {
-		runCommand(buttons[1]);
-		runCommand(nothing[2]);
-		runCommand(buttons[1]);
-		runCommand(nothing[4]);
-		runCommand(nothing[1]);
-		runCommand(buttons[1]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[3]);
-		runCommand(buttons[0]);
-		runCommand(nothing[2]);
-		runCommand(bMovement[2]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(buttons[1]);
-		runCommand(nothing[2]);
-		command longDown = {DOWN, 80};
-		runCommand(longDown);
-		runCommand(buttons[1]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[0]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[0]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[0]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[1]);
-		runCommand(buttons[1]);
-		runCommand(nothing[2]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[1]);
-		runCommand(bMovement[2]);
-		runCommand(nothing[1]);
-		runCommand(buttons[1]);
-		runCommand(nothing[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[0]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(bMovement[1]);
-		runCommand(buttons[1]);
-		runCommand(nothing[2]);
-		runCommand(buttons[0]);
-		runCommand(nothing[3]);
-		runCommand(buttons[0]);
-		runCommand(nothing[3]);
-		runCommand(buttons[2]);
-		runCommand(nothing[4]);
-		runCommand(nothing[3]);
-		runCommand(buttons[1]);
-		runCommand(nothing[3]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-		runCommand(nothing[4]);
-	}
-*/
-}
-
-void runCommandList(command moves[]) {
-	int a = 0;
-	for (a = 0; a < (sizeof(moves) / sizeof(moves[0])); a++) {
-		runCommand(moves[a]);
-	}
-}
-void runCommand(command move) {
-		duration_count = 0;
-		while(duration_count < move.duration) {
-			// We need to run our task to process and deliver data for our IN and OUT endpoints.
-			HID_Task(move);
-			// We also need to run the main USB management task.
-			USB_USBTask();
-		}
-
-}
-
-// collect will walk back and forth along the breeding bridge, and collect
-// a single egg from the day care worker.
-// To collect multiple eggs, put this in a loop (typically grabbing 5 at a time)
-void collect() {
-		//Walk left to right
-	int a;
-	// This for loop is a bit of a slider
-	// The fewer passes back and forth, the more quickly you'll get eggs with some
-	// error rate in eggs not being ready.
-	// The more passes made, gathering will be slower but with a higher
-	// success rate.
-	for (a = 0; a < 6; a ++) {
-		runCommand(run[0]);
-		runCommand(run[1]);
-		runCommand(run[2]);
-		runCommand(run[3]);
-		runCommand(run[4]);
-		runCommand(run[5]);
-	}
-
-	//Talk to day care lady
-	command a1 = {A, 5};
-	runCommand(a1);
-	command a2 = {NOTHING, 40};
-	runCommand(a2);
-	command a3 = {A, 5};
-	runCommand(a3);
-	command a4 = {NOTHING, 50};
-	runCommand(a4);
-
-	// Mash B
-	// We do this for 2 reasons:
-	// 1 as a safety check against when we talk to the day care lady and
-	// an egg wasn't ready for us.
-	// 2 to go through all the "Look, you got an egg! :D" flow.
-	int b;
-	for (b = 0; b < 13; b++) {
-		command b1 = {B, 15};
-		runCommand(b1);
-		command b2 = {NOTHING, 5};
-		runCommand(b2);
-	}
-
-	// Put this single egg away.
-	// We could run 5 times, and put the entire column away. That would be
-	// simpler, but potentially introduces a very-rare edge case where a pokemon
-	// hatches while we're collecting, so this puts them away immediately.
-
-	openBoxMultipurpose();
-	// The box opens with the cursor on first PC block. The egg will
-	// be the second party member.
-	command doNothing = {NOTHING, 10};
-	command o1 = {LEFT, 5};
-	runCommand(o1);
-	runCommand(doNothing);
-	command o2 = {DOWN, 5};
-	runCommand(o2);
-	runCommand(doNothing);
-	command o3 = {A, 5};
-	runCommand(o3);
-	runCommand(doNothing);
-	// With the pokemon picked up, move to the first PC block.
-	command o4 = {RIGHT, 5};
-	runCommand(o4);
-	runCommand(doNothing);
-	command o5 = {UP, 5};
-	runCommand(o5);
-	runCommand(doNothing);
-
-	// Now we're at 0, 0 on our grid, and can move to the exact spot to put the
-	// egg down.
-
-	int c;
-	for (c = 0; c < currentRow; c++) {
-		command c1 = {DOWN, 5};
-		runCommand(c1);
-		runCommand(doNothing);
-	}
-	int d;
-	for (d = 0; d < currentColumn; d++) {
-		command d1 = {RIGHT, 5};
-		runCommand(d1);
-		runCommand(doNothing);
-	}
-	command placePokemon = {A, 5};
-	runCommand(placePokemon);
-	runCommand(doNothing);
-
-	// Now that we've placed the pokemon, we just have to tell our future
-	// self where the next available row x col pair is.
-	currentRow++;
-	if (currentRow > 4) {
-		currentColumn++;
-		currentRow = 0;
-	}
-	if (currentColumn > 5) {
-		moveToNextBox();
-		currentColumn = 0;
-		boxesForward++;
-	}
-
-	// Cool, we've placed a pokemon, now just need to exit the PC and do it all again.
-	int e;
-	for (e = 0; e < 13; e++) {
-		command b1 = {B, 15};
-		runCommand(b1);
-		command b2 = {NOTHING, 5};
-		runCommand(b2);
-	}
-
-// TODO: mode change after # of eggs should be optional
-//	mode = FLY;
-}
-
-// hatch hatches a column of 5 eggs at a time.
-// Each call to hatch will hatch a single box of 30 eggs.
-void hatch() {
-	command doNothing = {NOTHING, 10};
-	command doUp = {UP, 5};
-	command doRight = {RIGHT, 5};
-	command doLeft = {LEFT, 5};
-	command doDown = {DOWN, 5};
-	command doA = {A, 5};
-	command doB = {B, 5};
-	int currCol;
-
-	// Grab the currCol column, put it in the party, then put it back.
-	for (currCol = 0; currCol < 6; currCol++) {
-		openBox();
-
-		//runCommand(doUp);
-		//runCommand(doNothing);
-
-		int c;
-		for (c = 0; c < currCol; c++) {
-			runCommand(doRight);
-			runCommand(doNothing);
-		}
-
-		selectColumn();
-
-		// The cursor is now at the top of the column holding a column of eggs.
-		int d;
-		for (d = 0; d <= currCol; d++) {
-			runCommand(doLeft);
-			runCommand(doNothing);
-		}
-		runCommand(doDown);
-		runCommand(doNothing);
-		runCommand(doA);
-		runCommand(doNothing);
-
-		// Mash B to get out of the box.
-		int b;
-		for (b = 0; b < 13; b++) {
-			runCommand(doB);
-			runCommand(doNothing);
-		}
-
-		// Now for the actual work.
-		// Run back and forth for ~2800 inputs.
-		// TODO: Is there a way to find #inputs:cycles in game?
-		// Since we're usually next to the day care lady, each pass through run[]
-		// is 160 inputs.
-		int r;
-		// A hatch happened at 53 for eevee.
-		for (r = 0; r < 55; r++) {
-			runCommand(run[0]);
-			runCommand(run[1]);
-			runCommand(run[2]);
-			runCommand(run[3]);
-			runCommand(run[4]);
-			runCommand(run[5]);
-		}
-
-		// More B mashing to get through all the egg hatch dialogue.
-		int numEggs;
-		for (numEggs = 0; numEggs < 5; numEggs++) {
-			int numEggsB;
-			// TODO: Can we optimize this time any?
-			for (numEggsB = 0; numEggsB < 80; numEggsB++){
-				runCommand(doB);
-				runCommand(doNothing);
-			}
-			// Very minor inputs to trigger the egg hatches
-			// Since we put them in the box immediately, they should hatch at the
-			// same time.
-			// duration of 5 doesn't always trigger the next hatch.
-			command doLeft20 = {LEFT, 20};
-			command doRight20 = {RIGHT, 20};
-			runCommand(doLeft20);
-			runCommand(doNothing);
-			runCommand(doRight20);
-			runCommand(doNothing);
-		}
-
-		// Now we have a party full of hatched pokemon and need to put them back.
-		openBox();
-		runCommand(doLeft);
-		runCommand(doNothing);
-		runCommand(doDown);
-		runCommand(doNothing);
-
-		selectColumn();
-
-		runCommand(doRight);
-		runCommand(doNothing);
-		runCommand(doUp);
-		runCommand(doNothing);
-
-		// We're back at 0, 0 and can put the hatched pokemon in their column.
-		int e;
-		for (e = 0; e < currCol; e++) {
-			runCommand(doRight);
-			runCommand(doNothing);
-		}
-		runCommand(doA);
-		runCommand(doNothing);
-
-		// Lastly, we mash B to exit the box.
-		int f;
-		for (f = 0; f < 13; f++) {
-			runCommand(doB);
-			runCommand(doNothing);
-		}
-	}
-}
-/*
-void hatch() {
-	int numCol;
-	for (numCol = 0; numCol < 6; numCol++) {
-		openBox();
-		if (numCol > 0) {
-			//put pokemon away
-			runCommand(movePokemon[0]);
-			runCommand(movePokemon[1]);
-			runCommand(movePokemon[4]);
-			runCommand(movePokemon[5]);
-
-			selectColumn();
-
-			//move to appropriate column
-			int currcol;
-			for (currcol = 0; currcol < numCol; currcol++) {
-				runCommand(movePokemon[2]);
-				runCommand(movePokemon[3]);
-			}
-			command up = {UP, 5};
-			command up2 = {NOTHING, 5};
-			runCommand(up);
-			runCommand(up2);
-			runCommand(grabColumn[0]);
-			runCommand(grabColumn[1]);
-
-			//Move to the right by 1
-			runCommand(movePokemon[2]);
-			runCommand(movePokemon[3]);
-		}
-		//Grab first set of eggs
-		selectColumn();
-
-		//Move them to party
-		int currcol2;
-		for (currcol2 = 0; currcol2 <= numCol; currcol2++) {
-			runCommand(movePokemon[0]);
-			runCommand(movePokemon[1]);
-		}
-		runCommand(movePokemon[4]);
-		runCommand(movePokemon[5]);
-		runCommand(movePokemon[6]);
-		runCommand(movePokemon[7]);
-
-		//Mash B
-		int b;
-		for (b = 0; b < 18; b++) {
-			command b1 = {B, 15};
-			runCommand(b1);
-			command b2 = {NOTHING, 5};
-			runCommand(b2);
-		}
-
-		//Hatch eggs
-		runCommand(spin[0]);
-		int numEggs;
-		for (numEggs = 0; numEggs < 5; numEggs++) {
-			int c;
-			for (c = 0; c < 37; c++) {
-				command b1 = {B, 15};
-				runCommand(b1);
-				command b2 = {NOTHING, 5};
-				runCommand(b2);
-			}
-			command shortspin = {SPIN, 20};
-			runCommand(shortspin);
-		}
-	}
-	openBox();
-
-	//put pokemon away
-	runCommand(movePokemon[0]);
-	runCommand(movePokemon[1]);
-	runCommand(movePokemon[4]);
-	runCommand(movePokemon[5]);
-
-	selectColumn();
-
-	//move to appropriate column
-	int currcol;
-	for (currcol = 0; currcol < 6; currcol++) {
-		runCommand(movePokemon[2]);
-		runCommand(movePokemon[3]);
-	}
-	command up = {UP, 5};
-	command up2 = {NOTHING, 5};
-	runCommand(up);
-	runCommand(up2);
-	runCommand(grabColumn[0]);
-	runCommand(grabColumn[1]);
-
-	runCommand(up);
-	runCommand(up2);
-	runCommand(movePokemon[2]);
-	runCommand(movePokemon[3]);
-
-	int d;
-	for (d = 0; d < 20; d++) {
-		command b1 = {B, 15};
-		runCommand(b1);
-		command b2 = {NOTHING, 5};
-		runCommand(b2);
-	}
-}
-*/
-// openBox opens your box in "Multiselect" mode, where an entire column
-// of pokemon can be moved at once.
-// Assumes menu is over "Pokemon" tab.
-void openBox() {
-	runCommand(openPC[0]);
-	runCommand(openPC[1]);
-	runCommand(openPC[2]);
-	runCommand(openPC[3]);
-	runCommand(openPC[4]);
-	runCommand(openPC[5]);
-	runCommand(openPC[6]);
-	runCommand(openPC[7]);
-	runCommand(openPC[8]);
-	runCommand(openPC[9]);
-}
-
-// openBoxMultipurpose opens your box in "multipurpose" mode,
-// where one can move a single pokemon at a time with only
-// a single "A" to pick them up.
-// Assumes menu is over "Pokemon" tab.
-void openBoxMultipurpose() {
-	runCommand(openPC[0]);
-	runCommand(openPC[1]);
-	runCommand(openPC[2]);
-	runCommand(openPC[3]);
-	runCommand(openPC[4]);
-	runCommand(openPC[5]);
-	runCommand(openPC[6]);
-	runCommand(openPC[7]);
-}
-
-// moveToNextBox moves to the next box in the PC.
-// Assumes the cursor is currently on the last block of the current box.
-void moveToNextBox() {
-	command doUp = {UP, 5};
-	command doNothing = {NOTHING, 10};
-	command doRight = {RIGHT, 5};
-	int a;
-	for (a = 0; a < 5; a++) {
-		runCommand(doUp);
-		runCommand(doNothing);
-	}
-	runCommand(doRight);
-	runCommand(doNothing);
-}
-
-void selectColumn() {
-	runCommand(grabColumn[0]);
-	runCommand(grabColumn[1]);
-	runCommand(grabColumn[2]);
-	runCommand(grabColumn[3]);
-	runCommand(grabColumn[4]);
-	runCommand(grabColumn[5]);
-	runCommand(grabColumn[6]);
-	runCommand(grabColumn[7]);
-	runCommand(grabColumn[8]);
-	runCommand(grabColumn[9]);
-	runCommand(grabColumn[10]);
-	runCommand(grabColumn[11]);
-}
-
-void putPokemonAway(int numCol) {
-	openBox();
-	command a5 = {L, 5};
-	runCommand(a5);
-	runCommand(nothing[1]);
-	runCommand(movePokemon[0]);
-	runCommand(movePokemon[1]);
-	runCommand(movePokemon[4]);
-	runCommand(movePokemon[5]);
-	selectColumn();
-	int currcol;
-	for (currcol = 0; currcol < numCol; currcol++) {
-		runCommand(movePokemon[2]);
-		runCommand(movePokemon[3]);
-	}
-	command up = {UP, 5};
-	command up2 = {NOTHING, 5};
-	runCommand(up);
-	runCommand(up2);
-	runCommand(grabColumn[0]);
-	runCommand(grabColumn[1]);
-
-	//Move to the right by 1
-	runCommand(movePokemon[2]);
-	runCommand(movePokemon[3]);
-}
-
-// Configures hardware and peripherals, such as the USB peripherals.
-void SetupHardware(void) {
-	// We need to disable watchdog if enabled by bootloader/fuses.
-	MCUSR &= ~(1 << WDRF);
-	wdt_disable();
-
-	// We need to disable clock division before initializing the USB hardware.
-	clock_prescale_set(clock_div_1);
-	// We can then initialize our hardware and peripherals, including the USB stack.
-
-	#ifdef ALERT_WHEN_DONE
-	// Both PORTD and PORTB will be used for the optional LED flashing and buzzer.
-	#warning LED and Buzzer functionality enabled. All pins on both PORTB and \
-PORTD will toggle when printing is done.
-	DDRD  = 0xFF; //Teensy uses PORTD
-	PORTD =  0x0;
-                  //We'll just flash all pins on both ports since the UNO R3
-	DDRB  = 0xFF; //uses PORTB. Micro can use either or, but both give us 2 LEDs
-	PORTB =  0x0; //The ATmega328P on the UNO will be resetting, so unplug it?
-	#endif
-	// The USB stack should be initialized last.
-	USB_Init();
-}
-
-// Fired to indicate that the device is enumerating.
-void EVENT_USB_Device_Connect(void) {
-	// We can indicate that we're enumerating here (via status LEDs, sound, etc.).
-}
-
-// Fired to indicate that the device is no longer connected to a host.
-void EVENT_USB_Device_Disconnect(void) {
-	// We can indicate that our device is not ready (via status LEDs, sound, etc.).
-}
-
-// Fired when the host set the current configuration of the USB device after enumeration.
-void EVENT_USB_Device_ConfigurationChanged(void) {
-	bool ConfigSuccess = true;
-
-	// We setup the HID report endpoints.
-	ConfigSuccess &= Endpoint_ConfigureEndpoint(JOYSTICK_OUT_EPADDR, EP_TYPE_INTERRUPT, JOYSTICK_EPSIZE, 1);
-	ConfigSuccess &= Endpoint_ConfigureEndpoint(JOYSTICK_IN_EPADDR, EP_TYPE_INTERRUPT, JOYSTICK_EPSIZE, 1);
-
-	// We can read ConfigSuccess to indicate a success or failure at this point.
-}
-
-// Process control requests sent to the device from the USB host.
-void EVENT_USB_Device_ControlRequest(void) {
-	// We can handle two control requests: a GetReport and a SetReport.
-
-	// Not used here, it looks like we don't receive control request from the Switch.
-}
-
-// Process and deliver data from IN and OUT endpoints.
-void HID_Task(command move) {
-	// If the device isn't connected and properly configured, we can't do anything here.
-	if (USB_DeviceState != DEVICE_STATE_Configured)
-		return;
-
-	// We'll start with the OUT endpoint.
-	Endpoint_SelectEndpoint(JOYSTICK_OUT_EPADDR);
-	// We'll check to see if we received something on the OUT endpoint.
-	if (Endpoint_IsOUTReceived())
-	{
-		// If we did, and the packet has data, we'll react to it.
-		if (Endpoint_IsReadWriteAllowed())
-		{
-			// We'll create a place to store our data received from the host.
-			USB_JoystickReport_Output_t JoystickOutputData;
-			// We'll then take in that data, setting it up in our storage.
-			while(Endpoint_Read_Stream_LE(&JoystickOutputData, sizeof(JoystickOutputData), NULL) != ENDPOINT_RWSTREAM_NoError);
-			// At this point, we can react to this data.
-
-			// However, since we're not doing anything with this data, we abandon it.
-		}
-		// Regardless of whether we reacted to the data, we acknowledge an OUT packet on this endpoint.
-		Endpoint_ClearOUT();
-	}
-
-	// We'll then move on to the IN endpoint.
-	Endpoint_SelectEndpoint(JOYSTICK_IN_EPADDR);
-	// We first check to see if the host is ready to accept data.
-	if (Endpoint_IsINReady())
-	{
-		// We'll create an empty report.
-		USB_JoystickReport_Input_t JoystickInputData;
-		// We'll then populate this report with what we want to send to the host.
-		GetNextReport(&JoystickInputData, move);
-		// Once populated, we can output this data to the host. We do this by first writing the data to the control stream.
-		while(Endpoint_Write_Stream_LE(&JoystickInputData, sizeof(JoystickInputData), NULL) != ENDPOINT_RWSTREAM_NoError);
-		// We then send an IN packet on this endpoint.
-		Endpoint_ClearIN();
-	}
-}
-
-typedef enum {
-	SYNC_CONTROLLER,
-	SYNC_POSITION,
-	BREATHE,
-	PROCESS,
-	CLEANUP,
-	DONE
-} State_t;
-State_t state = SYNC_CONTROLLER;Endpoint_Write_Stream;
-
-// Prepare the next report for the host.
-void GetNextReport(USB_JoystickReport_Input_t* const ReportData, command move) {
-
-	// Prepare an empty report
-	memset(ReportData, 0, sizeof(USB_JoystickReport_Input_t));
-	ReportData->LX = STICK_CENTER;
-	ReportData->LY = STICK_CENTER;
-	ReportData->RX = STICK_CENTER;
-	ReportData->RY = STICK_CENTER;
-	ReportData->HAT = HAT_CENTER;
-
-	// Repeat ECHOES times the last report
-	if (echoes > 0)
-	{
-		memcpy(ReportData, &last_report, sizeof(USB_JoystickReport_Input_t));
-		echoes--;
-		return;
-	}
-
-	// States and moves management
-	switch (state)
-	{
-		case SYNC_CONTROLLER:
-			state = BREATHE;
-			break;
-
-		case SYNC_POSITION:
-			ReportData->Button = 0;
-			ReportData->LX = STICK_CENTER;
-			ReportData->LY = STICK_CENTER;
-			ReportData->RX = STICK_CENTER;
-			ReportData->RY = STICK_CENTER;
-			ReportData->HAT = HAT_CENTER;
-
-
-			state = BREATHE;
-			break;
-
-		case BREATHE:
-			state = PROCESS;
-			break;
-
-		case PROCESS:
-
-			switch (move.button)
-			{
-
-				case UP:
-					ReportData->LY = STICK_MIN;
-					break;
-				case UPRIGHT:
-					ReportData->LY = STICK_MIN;
-					ReportData->LX = STICK_MAX;
-					break;
-
-				case LEFT:
-					ReportData->LX = STICK_MIN;
-					break;
-
-				case DOWN:
-					ReportData->LY = STICK_MAX;
-					break;
-
-				case RIGHT:
-					ReportData->LX = STICK_MAX;
-					break;
-
-				case PLUS:
-					ReportData->Button |= SWITCH_PLUS;
-					break;
-
-				case MINUS:
-					ReportData->Button |= SWITCH_MINUS;
-					break;
-
-				case A:
-					ReportData->Button |= SWITCH_A;
-					break;
-
-				case B:
-					ReportData->Button |= SWITCH_B;
-					break;
-
-				case X:
-					ReportData->Button |= SWITCH_X;
-					break;
-
-				case Y:
-					ReportData->Button |= SWITCH_Y;
-					break;
-
-				case R:
-					ReportData->Button |= SWITCH_R;
-					break;
-
-				case L:
-					ReportData->Button |= SWITCH_L;
-					break;
-
-				case THROW:
-					ReportData->LY = STICK_MIN;
-					ReportData->Button |= SWITCH_R;
-					break;
-
-				case HOME:
-					ReportData->Button |= SWITCH_HOME;
-					break;
-
-				case TRIGGERS:
-					ReportData->Button |= SWITCH_L | SWITCH_R;
-					break;
-
-				case SPIN:
-					ReportData->LX = STICK_MIN;
-					ReportData->RX = STICK_MAX;
-					break;
-
-				default:
-					ReportData->LX = STICK_CENTER;
-					ReportData->LY = STICK_CENTER;
-					ReportData->RX = STICK_CENTER;
-					ReportData->RY = STICK_CENTER;
-					ReportData->HAT = HAT_CENTER;
-					break;
-			}
-
-			duration_count++;  // Used to check against move.duration in runCommand
-			break;
-
-		case CLEANUP:
-			state = DONE;
-			break;
-
-		case DONE:
-			#ifdef ALERT_WHEN_DONE
-			portsval = ~portsval;
-			PORTD = portsval; //flash LED(s) and sound buzzer if attached
-			PORTB = portsval;
-			_delay_ms(250);
-			#endif
-			return;
-	}
-
-
-	// Prepare to echo this report
-	memcpy(&last_report, ReportData, sizeof(USB_JoystickReport_Input_t));
-	echoes = ECHOES;
-
-}
+/*
+Nintendo Switch Fightstick - Proof-of-Concept
+
+Based on the LUFA library's Low-Level Joystick Demo
+	(C) Dean Camera
+Based on the HORI's Pokken Tournament Pro Pad design
+	(C) HORI
+
+This project implements a modified version of HORI's Pokken Tournament Pro Pad
+USB descriptors to allow for the creation of custom controllers for the
+Nintendo Switch. This also works to a limited degree on the PS3.
+
+Since System Update v3.0.0, the Nintendo Switch recognizes the Pokken
+Tournament Pro Pad as a Pro Controller. Physical design limitations prevent
+the Pokken Controller from functioning at the same level as the Pro
+Controller. However, by default most of the descriptors are there, with the
+exception of Home and Capture. Descriptor modification allows us to unlock
+these buttons for our use.
+*/
+
+// make && sudo dfu-programmer atmega16u2 erase && sudo dfu-programmer atmega16u2 flash Joystick.hex
+
+// make && ./teensy_loader_cli -mmcu=atmega32u4 -w Joystick.hex
+
+#include "Joystick.h"
+#include <time.h>
+#include <stdio.h>
+
+// Time base
+// Command durations are in game frames. The Start-of-Frame interrupt counts
+// USB frames, which are exactly 1ms apart, and a command is reported until
+// its frames have elapsed in real time. Each command is also reported for at
+// least minPolls polls so that the game sees it for a whole frame whatever
+// the host poll rate; this replaces the old fixed ECHOES count.
+// The poll interval is measured from the time between IN polls once the host
+// has configured us. Until then we assume DEFAULT_POLL_MS.
+// Commands are timed against macroFrame, which only counts frames in which
+// the host is listening to us. While the console sleeps or re-enumerates the
+// controller the macro clock stands still, so the sequence picks up exactly
+// where it stopped once the controller has been paired again.
+#define DEFAULT_POLL_MS   8
+#define POLL_SAMPLES     16
+static volatile uint16_t usbFrame = 0;
+static volatile uint16_t macroFrame = 0;
+static uint16_t lastPollFrame = 0;
+static uint16_t pollSum = 0;
+static uint8_t pollCount = 0;
+uint8_t pollInterval = DEFAULT_POLL_MS;
+uint8_t minPolls = MIN_POLLS(DEFAULT_POLL_MS);
+// The macro frame the report being prepared is expected to go out in.
+static uint16_t reportFrame = 0;
+
+// Whether the host has polled us since it configured us, and the OUT
+// reports it has sent us and the USB frame of the last one.
+static volatile bool hostPolled = false;
+static volatile uint8_t outReports = 0;
+static volatile uint16_t lastOutFrame = 0;
+
+// Whether the host has configured us since power on, and whether it has
+// suspended, reset or dropped us since.
+static volatile bool linked = false;
+static volatile bool linkDropped = false;
+// Inputs being played to pair the controller again after the link came back,
+// or NULL. While they play the macro clock is held.
+static const uint8_t* volatile resync = NULL;
+static Buttons_t resyncButton;
+static uint16_t resyncEnd;
+
+// Every input we can send, pre-encoded as the report the host will see.
+// Producing a report is then a lookup per track merged into a neutral one.
+#define REPORT(button, lx, ly, rx, ry) \
+	{ .Button = (button), .HAT = HAT_CENTER, .LX = (lx), .LY = (ly), .RX = (rx), .RY = (ry), .VendorSpec = 0 }
+
+static const USB_JoystickReport_Input_t PROGMEM reportTable[] = {
+	[UP]       = REPORT(0,                     STICK_CENTER, STICK_MIN,    STICK_CENTER, STICK_CENTER),
+	[UPRIGHT]  = REPORT(0,                     STICK_MAX,    STICK_MIN,    STICK_CENTER, STICK_CENTER),
+	[DOWN]     = REPORT(0,                     STICK_CENTER, STICK_MAX,    STICK_CENTER, STICK_CENTER),
+	[LEFT]     = REPORT(0,                     STICK_MIN,    STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[RIGHT]    = REPORT(0,                     STICK_MAX,    STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[X]        = REPORT(SWITCH_X,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[Y]        = REPORT(SWITCH_Y,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[A]        = REPORT(SWITCH_A,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[B]        = REPORT(SWITCH_B,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[L]        = REPORT(SWITCH_L,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[R]        = REPORT(SWITCH_R,              STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[THROW]    = REPORT(SWITCH_R,              STICK_CENTER, STICK_MIN,    STICK_CENTER, STICK_CENTER),
+	[NOTHING]  = REPORT(0,                     STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[PLUS]     = REPORT(SWITCH_PLUS,           STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[MINUS]    = REPORT(SWITCH_MINUS,          STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[TRIGGERS] = REPORT(SWITCH_L | SWITCH_R,   STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER),
+	[SPIN]     = REPORT(0,                     STICK_MIN,    STICK_CENTER, STICK_MAX,    STICK_CENTER),
+	[HOME]     = REPORT(SWITCH_HOME,           STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER)
+};
+
+// The report for the host's next poll. The endpoint has a single bank, which
+// holds the report in flight, so this is the second buffer: it is prepared
+// right after a poll and is ready to copy out the moment the next one comes.
+static USB_JoystickReport_Input_t nextReport = REPORT(0, STICK_CENTER, STICK_CENTER, STICK_CENTER, STICK_CENTER);
+
+// Commands are played on independent tracks that are merged into every
+// report, so that for example B can be mashed while the character walks.
+// main() only enqueues commands onto a track's queue through runCommand()
+// and runCommandOn(); the Start-of-Frame interrupt takes them off the queues
+// and turns them into reports. head is only written by main() and tail only
+// by the interrupt. When a track's queue is empty it plays its background
+// loop, if it has one.
+#define QUEUE_SIZE 4
+typedef struct {
+	volatile command queue[QUEUE_SIZE];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	// The command currently being reported, owned by the interrupt.
+	volatile bool active;
+	command move;
+	// Scheduled end of move, in USB frames, and the polls it has been in.
+	uint16_t end;
+	uint8_t polls;
+	// Sequence looped while the queue is empty, or NULL.
+	const uint8_t* volatile loop;
+	const uint8_t* loopNext;
+} track;
+static track tracks[NUM_TRACKS];
+
+#ifdef ALERT_WHEN_DONE
+// Pins toggled by the LED and buzzer alert once the job is done.
+static uint8_t portsval = 0;
+#endif
+
+// The mode and its parameters (eggsToCollect, boxesToHatch, ...) are read
+// from EEPROM at boot into settings; see Settings.h.
+
+// COLLECTING keeps its place in seqVar: the boxes moved forward in
+// VAR_BOXES_FORWARD, and the row and column the next egg goes to in VAR_ROW
+// and VAR_COLUMN. Eggs are held in the party until a column is stored, so
+// VAR_ROW is also the number of eggs in the party.
+// Every column stored is added to the box map, which COLLECT_THEN_HATCH
+// then hatches, the last partial column included.
+
+static const uint8_t PROGMEM run[] = {
+	PRESS(LEFT,     116),
+	WAIT(8),
+	PRESS(RIGHT,    101),
+	WAIT(8),
+	PRESS(UPRIGHT,  58),
+	WAIT(15),
+	RETURN
+};
+
+
+// Assumes menu is already over "Pokemon"
+static const uint8_t PROGMEM openPCNormal[] = {
+	PRESS(X, 8),
+	WAIT(65),
+	PRESS(A, 8),
+	WAIT(101),
+	PRESS(R, 8),
+	WAIT(101),
+	RETURN
+};
+
+static const uint8_t PROGMEM openPCMultipurpose[] = {
+	CALL(SEQ_OPEN_BOX_NORMAL),
+	// Puts in "multipurpose" select mode
+	PRESS(Y, 8),
+	WAIT(8),
+	RETURN
+};
+
+static const uint8_t PROGMEM openPC[] = {
+	CALL(SEQ_OPEN_BOX_MULTIPURPOSE),
+	// Puts in "multiselect" select mode
+	PRESS(Y, 8),
+	WAIT(8),
+	RETURN
+};
+
+// Mash B to back out of the PC and the menu.
+static const uint8_t PROGMEM closeMenus[] = {
+	REPEAT(13),
+		PRESS(B, 22),
+		WAIT(8),
+	NEXT,
+	RETURN
+};
+
+// The same as closeMenus with the shorter presses used around hatching.
+static const uint8_t PROGMEM closeBox[] = {
+	REPEAT(13),
+		PRESS(B, 8),
+		WAIT(15),
+	NEXT,
+	RETURN
+};
+
+// Tapping B, looped in the background to clear dialogue.
+static const uint8_t PROGMEM mashB[] = {
+	PRESS(B, 8),
+	WAIT(15),
+	RETURN
+};
+
+// Release the pokemon under the cursor in the normal box mode: open its
+// menu, pick "Release" from the bottom of it and confirm. Once the last A
+// has gone out the pokemon is gone; releaseDialogue clears the dialogues
+// that follow. The cursor stays on the now empty slot.
+static const uint8_t PROGMEM releasePokemon[] = {
+	PRESS(A, 8),
+	WAIT(15),
+	// "Release" is second from the bottom of the menu, which wraps.
+	PRESS(UP, 8),
+	WAIT(8),
+	PRESS(UP, 8),
+	WAIT(8),
+	PRESS(A, 8),
+	// "Do you really want to release it?" opens on "No". An early A here
+	// would answer it, so this one wait can't be overlapped.
+	WAIT(58),
+	PRESS(UP, 8),
+	WAIT(8),
+	PRESS(A, 8),
+	RETURN
+};
+
+// A on an empty slot does nothing, so once the pokemon is gone A can be
+// mashed at the shortest gap the menus take to clear "... was released."
+// and "Bye-bye, ...!" as soon as each can be closed, however many there
+// are. The window ends a mash after the point the old single A closed the
+// last of them; A is caught up before the cursor moves on, as it would open
+// the menu of the next pokemon.
+#define RELEASE_DIALOGUE 110
+
+static const uint8_t PROGMEM mashA[] = {
+	PRESS(A, 8),
+	WAIT(8),
+	RETURN
+};
+
+static const uint8_t PROGMEM releaseDialogue[] = {
+	BACKGROUND(TRACK_BUTTONS, SEQ_MASH_A),
+	WAIT(RELEASE_DIALOGUE),
+	STOP(TRACK_BUTTONS),
+	SYNC,
+	WAIT(15),
+	RETURN
+};
+
+// Controller setup on the "Change Grip/Order" screen is driven by the host:
+// L+R is held from its first poll until it answers with an OUT report, and
+// once A has closed the screen we move on as soon as its OUT traffic stops.
+// The limits, in game frames, keep startup going with a host that sends
+// nothing.
+#define PAIR_STEP      2
+#define PAIR_HOLD     72
+#define PAIR_QUIET    30
+#define PAIR_CLOSE   120
+
+static const uint8_t PROGMEM pairConfirm[] = {
+	WAIT(8),
+	PRESS(A, 8),
+	RETURN
+};
+
+// Played from the interrupt when the host takes us back after a sleep or a
+// reset. The game is paused behind the "Controllers" screen the console puts
+// up for a lost controller, so pairing on it is safe wherever the sequence
+// stopped. Presses and waits only.
+static const uint8_t PROGMEM resyncController[] = {
+	WAIT(30),
+	PRESS(TRIGGERS, 72),
+	WAIT(8),
+	PRESS(A, 72),
+	WAIT(60),
+	RETURN
+};
+
+static const uint8_t PROGMEM enterBridge[] = {
+	PRESS(UPRIGHT, 202),
+	RETURN
+};
+
+// Passes of run[] that go by while a hatch dialogue is up (~20s). Steps
+// don't count during the dialogue.
+#define HATCH_DIALOGUE_PASSES 4
+
+// hatchParty walks until the eggs in the party have all hatched.
+static const uint8_t PROGMEM hatchParty[] = {
+	BACKGROUND(TRACK_BUTTONS, SEQ_MASH_B),
+	REPEAT_VAR(VAR_HATCH_PASSES, 0),
+		CALL(SEQ_RUN),
+	NEXT,
+
+	// Keep walking for about as long as the dialogue of each egg takes.
+	REPEAT_VAR(VAR_PARTY_EGGS, 0),
+		REPEAT(HATCH_DIALOGUE_PASSES),
+			CALL(SEQ_RUN),
+		NEXT,
+	NEXT,
+	STOP(TRACK_BUTTONS),
+	SYNC,
+	RETURN
+};
+
+// Eggs carried in the party behind the lead. Collecting stores them as a
+// column once there are 5. COLLECT_AND_HATCH lets them hatch while we walk
+// for the next egg, and every new egg takes the party slot of the oldest one,
+// which has been walked for 5 collections by then.
+#define PARTY_EGGS 5
+
+// Walk for the next egg with B mashed on its own track to clear the hatch
+// dialogues on the way. B has to be stopped and caught up before talking to
+// the day care lady, or it would answer her.
+static const uint8_t PROGMEM walkAndHatch[] = {
+	BACKGROUND(TRACK_BUTTONS, SEQ_MASH_B),
+	REPEAT_VAR(VAR_COLLECT_PASSES, 0),
+		CALL(SEQ_RUN),
+	NEXT,
+	STOP(TRACK_BUTTONS),
+	SYNC,
+	RETURN
+};
+
+// While the party has room the egg simply joins it.
+static const uint8_t PROGMEM takeEgg[] = {
+	//Talk to day care lady
+	PRESS(A, 8),
+	WAIT(58),
+	PRESS(A, 8),
+	WAIT(72),
+	// Mash B
+	// We do this for 2 reasons:
+	// 1 as a safety check against when we talk to the day care lady and
+	// an egg wasn't ready for us.
+	// 2 to go through all the "Look, you got an egg! :D" flow.
+	CALL(SEQ_CLOSE_MENUS),
+	RETURN
+};
+
+// With a full party the game asks whether to add the egg to the party, and
+// which member to send to the box in its place. Swap out VAR_PARTY_SLOT.
+static const uint8_t PROGMEM swapEgg[] = {
+	//Talk to day care lady
+	PRESS(A, 8),
+	WAIT(58),
+	PRESS(A, 8),
+	WAIT(72),
+	// "Yes" is already selected; the party list opens on the lead.
+	PRESS(A, 8),
+	WAIT(72),
+	REPEAT_VAR(VAR_PARTY_SLOT, 0),
+		PRESS(DOWN, 8),
+		WAIT(15),
+	NEXT,
+	PRESS(A, 8),
+	WAIT(72),
+	// Mash B through "... was sent to the box", or out of the dialogue if
+	// the egg wasn't ready.
+	CALL(SEQ_CLOSE_MENUS),
+	RETURN
+};
+
+// The table is linked whatever the job, so a build with the job fixed only
+// fills in the sequences its job plays. The rest are then left out of the
+// image along with the routines of the other modes.
+#ifdef CFG_FIXED
+#define JOB_WALKS     (CFG_MODE != RELEASING)
+#define JOB_HATCHES   (CFG_MODE == HATCHING || CFG_MODE == COLLECT_THEN_HATCH)
+#define JOB_OPENS_BOX (JOB_HATCHES || CFG_MODE == COLLECTING)
+#define JOB_RELEASES  (CFG_MODE == RELEASING || (JOB_HATCHES && CFG_RELEASE_HATCHED))
+#define JOB_SEQ(job, seq) ((job) ? (seq) : NULL)
+#else
+#define JOB_SEQ(job, seq) (seq)
+#endif
+
+const uint8_t* const sequences[] PROGMEM = {
+	[SEQ_RUN]                   = JOB_SEQ(JOB_WALKS, run),
+	[SEQ_OPEN_BOX]              = JOB_SEQ(JOB_OPENS_BOX, openPC),
+	[SEQ_OPEN_BOX_MULTIPURPOSE] = JOB_SEQ(JOB_OPENS_BOX, openPCMultipurpose),
+	[SEQ_OPEN_BOX_NORMAL]       = JOB_SEQ(JOB_OPENS_BOX || CFG_MODE == RELEASING, openPCNormal),
+	[SEQ_RELEASE]               = JOB_SEQ(JOB_RELEASES, releasePokemon),
+	[SEQ_RELEASE_DIALOGUE]      = JOB_SEQ(JOB_RELEASES, releaseDialogue),
+	[SEQ_CLOSE_MENUS]           = closeMenus,
+	[SEQ_CLOSE_BOX]             = JOB_SEQ(JOB_HATCHES, closeBox),
+	[SEQ_MASH_B]                = JOB_SEQ(JOB_WALKS, mashB),
+	[SEQ_MASH_A]                = JOB_SEQ(JOB_RELEASES, mashA),
+	[SEQ_HATCH_PARTY]           = JOB_SEQ(JOB_HATCHES || CFG_MODE == COLLECT_AND_HATCH, hatchParty)
+};
+
+// Main entry point.
+int main(void) {
+	// We'll start by performing hardware and peripheral setup.
+	SetupHardware();
+	// We'll then read which job to do and its parameters, unless they were
+	// fixed at build time.
+	#ifndef CFG_FIXED
+	loadSettings();
+	#endif
+	Modes mode = CFG_MODE;
+	seqVar[VAR_COLLECT_PASSES] = CFG_COLLECT_PASSES;
+	seqVar[VAR_HATCH_PASSES] = hatchPasses();
+	// A job that was cut short, by a power cut or a USB reset, carries on from
+	// its last checkpoint.
+	bool resume = loadCheckpoint();
+	CheckpointPhase_t phase = resume ? checkpoint.phase : CHECKPOINT_NONE;
+	// We'll then enable global interrupts for our use.
+	GlobalInterruptEnable();
+	pairController();
+	if (resume) {
+		// Back out of whatever menu or dialogue the game was left in.
+		PROFILE_ENTER(PHASE_CLOSE_MENUS);
+		runSequenceId(SEQ_CLOSE_MENUS);
+		PROFILE_EXIT(PHASE_CLOSE_MENUS);
+	} else if (mode == COLLECTING || mode == COLLECT_THEN_HATCH || mode == COLLECT_AND_HATCH) {
+		PROFILE_ENTER(PHASE_WALK);
+		runSequence(enterBridge);
+		PROFILE_EXIT(PHASE_WALK);
+	}
+	if (mode == HATCHING) {
+		// The boxes are filled as configured.
+		boxMapFill(CFG_BOXES, CFG_HATCH_COLUMNS);
+	}
+	if (mode == COLLECTING || mode == COLLECT_THEN_HATCH) {
+		uint16_t i = 0;
+		if (phase == CHECKPOINT_COLLECT)
+			i = restoreCollection(checkpoint.count, checkpoint.col);
+		else if (phase != CHECKPOINT_NONE)
+			i = restoreCollection(CFG_EGGS, 0);
+		if (phase == CHECKPOINT_NONE || phase == CHECKPOINT_COLLECT) {
+			for (; i < CFG_EGGS; i++) {
+				collect();
+				saveCheckpoint(CHECKPOINT_COLLECT, i + 1, 0, seqVar[VAR_ROW]);
+			}
+			if (seqVar[VAR_ROW] > 0) {
+				storeParty();
+				saveCheckpoint(CHECKPOINT_COLLECT, CFG_EGGS, 0, 0);
+			}
+		}
+	}
+	if (mode == COLLECT_AND_HATCH) {
+		uint16_t i = phase == CHECKPOINT_PIPELINE ? checkpoint.count : 0;
+		seqVar[VAR_COLLECT_PASSES] = pipelinePasses();
+		for (; i < CFG_EGGS; i++) {
+			collectAndHatch(i);
+			saveCheckpoint(CHECKPOINT_PIPELINE, i + 1, 0, 0);
+		}
+		// The last eggs to join the party still need the whole walk.
+		seqVar[VAR_PARTY_EGGS] = CFG_EGGS < PARTY_EGGS ? CFG_EGGS : PARTY_EGGS;
+		PROFILE_ENTER(PHASE_HATCH_WALK);
+		runSequenceId(SEQ_HATCH_PARTY);
+		PROFILE_EXIT(PHASE_HATCH_WALK);
+	}
+	if (mode == COLLECT_THEN_HATCH && (phase == CHECKPOINT_NONE || phase == CHECKPOINT_COLLECT)) {
+		// We moved forward in the box during egg collecting.
+		// So we have to move back to the box we started at in the PC.
+		uint8_t i;
+		PROFILE_ENTER(PHASE_RETURN);
+		openBox();
+		for (i = 0; i < seqVar[VAR_BOXES_FORWARD]; i++) {
+			boxPrevBox();
+		}
+		PROFILE_ENTER(PHASE_CLOSE_MENUS);
+		runSequenceId(SEQ_CLOSE_MENUS);
+		PROFILE_EXIT(PHASE_CLOSE_MENUS);
+		PROFILE_EXIT(PHASE_RETURN);
+		saveCheckpoint(CHECKPOINT_HATCH_START, 0, 0, 0);
+	}
+	if (mode == COLLECT_THEN_HATCH || mode == HATCHING) {
+		if (phase == CHECKPOINT_HATCH)
+			hatch(checkpoint.box, checkpoint.col, true);
+		else
+			hatch(0, 0, false);
+	}
+	if (mode == RELEASING) {
+		if (phase == CHECKPOINT_RELEASE)
+			release(checkpoint.box, checkpoint.count, CFG_RELEASE_BOXES);
+		else
+			release(0, 0, CFG_RELEASE_BOXES);
+	}
+	// The job is done, so the next one starts afresh.
+	saveCheckpoint(CHECKPOINT_NONE, 0, 0, 0);
+	flushCommands();
+	PROFILE_END();
+	return 0;
+}
+
+// runCommand queues move on the main track.
+void runCommand(command move) {
+	runCommandOn(TRACK_MAIN, move);
+}
+
+// runCommandOn queues move to be played on track t after everything already
+// queued there. It only blocks while the queue is full, idling the core until
+// the interrupt has made room.
+void runCommandOn(uint8_t t, command move) {
+	track* tr = &tracks[t];
+	if (move.duration == 0)
+		return;
+
+	uint8_t next = (tr->head + 1) & (QUEUE_SIZE - 1);
+	while (next == tr->tail)
+		idle();
+
+	tr->queue[tr->head] = move;
+	tr->head = next;
+	PROFILE_QUEUED(t);
+}
+
+// startBackground loops seq on track t whenever it has nothing queued. seq
+// may only hold presses and waits.
+void startBackground(uint8_t t, const uint8_t* seq) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		tracks[t].loopNext = seq;
+		tracks[t].loop = seq;
+	}
+}
+
+// stopBackground ends the loop on track t once its current input is done.
+void stopBackground(uint8_t t) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		tracks[t].loop = NULL;
+	}
+}
+
+// flushCommands waits until every queued command has been played. Tracks
+// running a background loop count as done once their queue is empty.
+void flushCommands(void) {
+	uint8_t t;
+	for (t = 0; t < NUM_TRACKS; t++) {
+		track* tr = &tracks[t];
+		while (tr->head != tr->tail || (tr->active && tr->loop == NULL))
+			idle();
+	}
+}
+
+// idle sleeps until the next interrupt, running the USB management task in
+// between so that control requests keep being answered.
+void idle(void) {
+	USB_USBTask();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_mode();
+}
+
+// Read a frame count kept by the interrupt.
+static uint16_t readFrame(volatile uint16_t* frame) {
+	uint16_t value;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		value = *frame;
+	}
+	return value;
+}
+
+// pairController pairs the controller on the "Change Grip/Order" screen as
+// fast as the host takes it.
+void pairController(void) {
+	command hold = {TRIGGERS, PAIR_STEP};
+	uint8_t outs;
+	uint16_t start;
+
+	PROFILE_ENTER(PHASE_PAIR);
+	// Nothing we send is seen before the host polls.
+	while (!hostPolled)
+		idle();
+
+	// Hold L+R until the screen answers by sending us an OUT report.
+	outs = outReports;
+	start = readFrame(&usbFrame);
+	while (outReports == outs && readFrame(&usbFrame) - start < FRAMES_TO_MS(PAIR_HOLD))
+		runCommand(hold);
+
+	// Close the screen with A, and wait for the host to go quiet.
+	runSequence(pairConfirm);
+	flushCommands();
+	start = readFrame(&usbFrame);
+	while (readFrame(&usbFrame) - readFrame(&lastOutFrame) < FRAMES_TO_MS(PAIR_QUIET)
+			&& readFrame(&usbFrame) - start < FRAMES_TO_MS(PAIR_CLOSE))
+		idle();
+	PROFILE_EXIT(PHASE_PAIR);
+}
+
+// collect will walk back and forth along the breeding bridge, and collect
+// a single egg from the day care worker into the party.
+// To collect multiple eggs, put this in a loop. Every 5 eggs are stored as a
+// column; call storeParty() after the loop to store the last, partial one.
+// An egg that hatches on the way is handled by the B mashed while walking,
+// and is stored along with the eggs.
+void collect() {
+	PROFILE_ENTER(PHASE_COLLECT);
+	PROFILE_ENTER(PHASE_WALK);
+	runSequence(walkAndHatch);
+	PROFILE_EXIT(PHASE_WALK);
+	PROFILE_ENTER(PHASE_DAY_CARE);
+	runSequence(takeEgg);
+	PROFILE_EXIT(PHASE_DAY_CARE);
+
+	seqVar[VAR_ROW]++;
+	if (seqVar[VAR_ROW] == PARTY_EGGS)
+		storeParty();
+	PROFILE_EXIT(PHASE_COLLECT);
+}
+
+// storeParty stores the eggs held in the party as a column of the box.
+void storeParty() {
+	PROFILE_ENTER(PHASE_STORE);
+	openBox();
+	boxPartyToColumn(seqVar[VAR_COLUMN], seqVar[VAR_ROW]);
+	boxMapAdd(seqVar[VAR_BOXES_FORWARD], seqVar[VAR_COLUMN], seqVar[VAR_ROW]);
+
+	// Now that we've placed the column, we just have to tell our future
+	// self where the next available column is.
+	seqVar[VAR_ROW] = 0;
+	seqVar[VAR_COLUMN]++;
+	if (seqVar[VAR_COLUMN] > 5) {
+		boxNextBox();
+		seqVar[VAR_COLUMN] = 0;
+		seqVar[VAR_BOXES_FORWARD]++;
+	}
+
+	// Cool, we've placed the eggs, now just need to exit the PC and do it all again.
+	PROFILE_ENTER(PHASE_CLOSE_MENUS);
+	runSequenceId(SEQ_CLOSE_MENUS);
+	PROFILE_EXIT(PHASE_CLOSE_MENUS);
+	PROFILE_EXIT(PHASE_STORE);
+}
+
+// collectAndHatch walks for the egg-th egg of a COLLECT_AND_HATCH run and
+// adds it to the party, hatching the eggs already there on the way.
+void collectAndHatch(uint16_t egg) {
+	PROFILE_ENTER(PHASE_COLLECT);
+	PROFILE_ENTER(PHASE_WALK);
+	runSequence(walkAndHatch);
+	PROFILE_EXIT(PHASE_WALK);
+	PROFILE_ENTER(PHASE_DAY_CARE);
+	if (egg < PARTY_EGGS) {
+		runSequence(takeEgg);
+	} else {
+		// Slot 0 is the lead; the oldest egg sits in the slot this one
+		// took PARTY_EGGS collections ago.
+		seqVar[VAR_PARTY_SLOT] = 1 + egg % PARTY_EGGS;
+		runSequence(swapEgg);
+	}
+	PROFILE_EXIT(PHASE_DAY_CARE);
+	PROFILE_EXIT(PHASE_COLLECT);
+}
+
+// restoreCollection sets the box position and the box map up as they were
+// once eggs eggs had been collected, the last held of them still in the
+// party and the rest stored, and returns eggs.
+uint16_t restoreCollection(uint16_t eggs, uint8_t held) {
+	uint16_t stored = eggs - held;
+	uint8_t columns = (stored + BOX_ROWS - 1) / BOX_ROWS;
+	uint8_t c;
+	for (c = 0; c < columns; c++) {
+		uint8_t rows = c < stored / BOX_ROWS ? BOX_ROWS : stored % BOX_ROWS;
+		boxMapAdd(c / BOX_COLUMNS, c % BOX_COLUMNS, rows);
+	}
+	seqVar[VAR_ROW] = held;
+	seqVar[VAR_COLUMN] = columns % BOX_COLUMNS;
+	seqVar[VAR_BOXES_FORWARD] = columns / BOX_COLUMNS;
+	return eggs;
+}
+
+// Steps walked per pass of run[] (306 frames). Measured: a 35 cycle Eevee
+// hatched on the 53rd pass with Flame Body in the party (35 * 257 / 2 / 53).
+#define STEPS_PER_PASS  85
+// Steps in an egg cycle.
+#define STEPS_PER_CYCLE 257
+
+// hatchPasses works out how many passes of run[] it takes until a column of
+// eggs picked up together is due to hatch, unless CFG_HATCH_PASSES fixes
+// the number.
+uint8_t hatchPasses(void) {
+	if (CFG_HATCH_PASSES != 0)
+		return CFG_HATCH_PASSES;
+
+	uint16_t steps = CFG_CYCLES * STEPS_PER_CYCLE;
+	// Flame Body and Magma Armor halve the steps, rounding up.
+	if (CFG_FLAME_BODY)
+		steps = (steps + 1) / 2;
+	// One extra pass covers the steps lost turning at the ends of the bridge.
+	return (steps + STEPS_PER_PASS - 1) / STEPS_PER_PASS + 1;
+}
+
+// pipelinePasses works out the passes of run[] between eggs in
+// COLLECT_AND_HATCH. An egg is swapped out of the party PARTY_EGGS eggs after
+// it joined, so it needs to have hatched by then. About one egg hatches per
+// walk, and its dialogue costs HATCH_DIALOGUE_PASSES of the walk's steps.
+uint8_t pipelinePasses(void) {
+	uint8_t passes = (hatchPasses() + PARTY_EGGS - 1) / PARTY_EGGS + HATCH_DIALOGUE_PASSES;
+	if (passes < CFG_COLLECT_PASSES)
+		passes = CFG_COLLECT_PASSES;
+	return passes;
+}
+
+// hatch hatches the eggs in the box map a column at a time, from column col
+// of box box on. Empty columns and boxes are skipped, and a partial column is
+// walked only for the eggs it holds. Each visit to the box puts the hatched
+// column back and picks up the next one, moving on through the boxes as
+// needed. If holding, the party already holds that column and the PC shows
+// its box; otherwise the PC shows the first box.
+void hatch(uint8_t box, uint8_t col, bool holding) {
+	uint8_t eggs = boxMapNext(&box, &col);
+	uint8_t i;
+	if (eggs == 0)
+		return;
+
+	PROFILE_ENTER(PHASE_HATCH);
+	if (!holding) {
+		openBox();
+		for (i = 0; i < box; i++)
+			boxNextBox();
+		boxColumnToParty(col);
+		// Mash B to get out of the box.
+		PROFILE_ENTER(PHASE_CLOSE_MENUS);
+		runSequenceId(SEQ_CLOSE_BOX);
+		PROFILE_EXIT(PHASE_CLOSE_MENUS);
+		saveCheckpoint(CHECKPOINT_HATCH, 0, box, col);
+	}
+
+	while (eggs) {
+		// Now for the actual work.
+		// Run back and forth, mashing B on its own track the whole time. Each
+		// egg's hatch dialogue is cleared as soon as it comes up and we carry on
+		// walking straight after, so eggs that are due a little later than the
+		// first still hatch on the way.
+		// How far we walk comes from hatchPasses().
+		seqVar[VAR_PARTY_EGGS] = eggs;
+		PROFILE_ENTER(PHASE_HATCH_WALK);
+		runSequenceId(SEQ_HATCH_PARTY);
+		PROFILE_EXIT(PHASE_HATCH_WALK);
+
+		// Now we have a party full of hatched pokemon and need to put them
+		// back, then grab the next column.
+		openBox();
+		boxPartyToColumn(col, eggs);
+		// The box is open anyway, so the hatched column can be released
+		// straight away, leaving its slots free for the next collection. Only
+		// the eggs' rows hold anything.
+		if (CFG_RELEASE_HATCHED)
+			boxReleaseColumn(box, col, CFG_KEEP(col));
+
+		uint8_t nextBox = box;
+		col++;
+		eggs = boxMapNext(&nextBox, &col);
+		if (eggs) {
+			for (; box < nextBox; box++)
+				boxNextBox();
+			boxColumnToParty(col);
+		}
+		// Lastly, we mash B to exit the box.
+		PROFILE_ENTER(PHASE_CLOSE_MENUS);
+		runSequenceId(SEQ_CLOSE_BOX);
+		PROFILE_EXIT(PHASE_CLOSE_MENUS);
+		if (eggs)
+			saveCheckpoint(CHECKPOINT_HATCH, 0, box, col);
+	}
+	PROFILE_EXIT(PHASE_HATCH);
+}
+
+// release releases every pokemon in boxes boxes, starting from the box the
+// PC opens on, which is box from of them, after the first slots of it that
+// were released already. The slots are visited in a serpentine: down one
+// column, up the next, and back across the next box the way we came, so
+// every step to the next slot is a single press. A checkpoint is saved as
+// each pokemon goes, so that a resumed job never tries to release an empty
+// slot; only a reset in the moment between the confirming press and its
+// checkpoint can leave one behind.
+void release(uint8_t from, uint8_t slots, uint8_t boxes) {
+	uint8_t box, i, j;
+	if (from >= boxes)
+		return;
+
+	PROFILE_ENTER(PHASE_RELEASE);
+	openBoxNormal();
+	for (box = from; box < boxes; box++) {
+		// Each box has an even number of columns, so the first of every box
+		// goes down.
+		for (i = 0; i < BOX_COLUMNS; i++) {
+			uint8_t col = (box & 1) ? BOX_COLUMNS - 1 - i : i;
+			for (j = 0; j < BOX_ROWS; j++) {
+				uint8_t slot = i * BOX_ROWS + j;
+				if (box == from && slot < slots)
+					continue;
+				boxReleaseStart((i & 1) ? BOX_ROWS - 1 - j : j, col);
+				saveCheckpoint(CHECKPOINT_RELEASE, slot + 1, box, 0);
+				boxReleaseEnd();
+			}
+		}
+		if (box + 1 < boxes) {
+			boxNextBox();
+			saveCheckpoint(CHECKPOINT_RELEASE, 0, box + 1, 0);
+		}
+	}
+	PROFILE_ENTER(PHASE_CLOSE_MENUS);
+	runSequenceId(SEQ_CLOSE_MENUS);
+	PROFILE_EXIT(PHASE_CLOSE_MENUS);
+	PROFILE_EXIT(PHASE_RELEASE);
+}
+
+// Configures hardware and peripherals, such as the USB peripherals.
+void SetupHardware(void) {
+	// We need to disable watchdog if enabled by bootloader/fuses.
+	MCUSR &= ~(1 << WDRF);
+	wdt_disable();
+
+	// We need to disable clock division before initializing the USB hardware.
+	clock_prescale_set(clock_div_1);
+	// We can then initialize our hardware and peripherals, including the USB stack.
+
+	#ifdef ALERT_WHEN_DONE
+	// Both PORTD and PORTB will be used for the optional LED flashing and buzzer.
+	#warning LED and Buzzer functionality enabled. All pins on both PORTB and \
+PORTD will toggle when printing is done.
+	DDRD  = 0xFF; //Teensy uses PORTD
+	PORTD =  0x0;
+                  //We'll just flash all pins on both ports since the UNO R3
+	DDRB  = 0xFF; //uses PORTB. Micro can use either or, but both give us 2 LEDs
+	PORTB =  0x0; //The ATmega328P on the UNO will be resetting, so unplug it?
+	#endif
+	// The USB stack should be initialized last.
+	USB_Init();
+}
+
+// The host has stopped listening to us. The macro clock stops with the
+// Start-of-Frame interrupts or the configuration, and the controller is
+// paired again once the host is back.
+static void dropLink(void) {
+	if (linked)
+		linkDropped = true;
+}
+
+// The host is listening again. Pair the controller before the sequence
+// carries on.
+static void restoreLink(void) {
+	if (linkDropped) {
+		linkDropped = false;
+		resyncEnd = usbFrame;
+		resync = resyncController;
+	}
+	linked = true;
+}
+
+// Fired to indicate that the device is enumerating.
+void EVENT_USB_Device_Connect(void) {
+	// We can indicate that we're enumerating here (via status LEDs, sound, etc.).
+}
+
+// Fired to indicate that the device is no longer connected to a host.
+void EVENT_USB_Device_Disconnect(void) {
+	dropLink();
+}
+
+// Fired when the host resets the bus, before enumerating us again.
+void EVENT_USB_Device_Reset(void) {
+	dropLink();
+}
+
+// Fired when the host suspends the bus, as when the console goes to sleep.
+void EVENT_USB_Device_Suspend(void) {
+	dropLink();
+}
+
+// Fired when the bus wakes up again. We stay configured across a suspend, so
+// this is where the link comes back.
+void EVENT_USB_Device_WakeUp(void) {
+	if (USB_DeviceState == DEVICE_STATE_Configured)
+		restoreLink();
+}
+
+// Fired when the host set the current configuration of the USB device after enumeration.
+void EVENT_USB_Device_ConfigurationChanged(void) {
+	bool ConfigSuccess = true;
+
+	// We setup the HID report endpoints.
+	ConfigSuccess &= Endpoint_ConfigureEndpoint(JOYSTICK_OUT_EPADDR, EP_TYPE_INTERRUPT, JOYSTICK_EPSIZE, 1);
+	ConfigSuccess &= Endpoint_ConfigureEndpoint(JOYSTICK_IN_EPADDR, EP_TYPE_INTERRUPT, JOYSTICK_EPSIZE, 1);
+
+	// Reports are produced from the Start-of-Frame interrupt, once every 1ms.
+	// Measure the poll interval of this host from scratch.
+	pollCount = 0;
+	pollSum = 0;
+	hostPolled = false;
+	USB_Device_EnableSOFEvents();
+	restoreLink();
+
+	// We can read ConfigSuccess to indicate a success or failure at this point.
+}
+
+// Process control requests sent to the device from the USB host.
+void EVENT_USB_Device_ControlRequest(void) {
+	// We can handle two control requests: a GetReport and a SetReport.
+
+	// Not used here, it looks like we don't receive control request from the Switch.
+}
+
+// Copy a report into the selected endpoint bank. The endpoint is 64 bytes
+// and was free when the host polled, so this never has to wait.
+static inline void WriteReport(const USB_JoystickReport_Input_t* report) {
+	const uint8_t* data = (const uint8_t*)report;
+	uint8_t i;
+	for (i = 0; i < sizeof(USB_JoystickReport_Input_t); i++)
+		Endpoint_Write_8(*data++);
+}
+
+// Time the gap between IN polls. Once POLL_SAMPLES gaps have been seen the
+// average becomes the poll interval used for minPolls.
+static void measurePoll(void) {
+	if (pollCount > POLL_SAMPLES)
+		return;
+
+	uint16_t gap = usbFrame - lastPollFrame;
+	lastPollFrame = usbFrame;
+	// The first poll only gives us a starting point.
+	if (pollCount++ == 0)
+		return;
+
+	pollSum += gap;
+	if (pollCount > POLL_SAMPLES) {
+		pollInterval = (pollSum + POLL_SAMPLES / 2) / POLL_SAMPLES;
+		if (pollInterval == 0)
+			pollInterval = 1;
+		minPolls = MIN_POLLS(pollInterval);
+	}
+}
+
+// Fired from the USB interrupt at the start of every 1ms USB frame.
+void EVENT_USB_Device_StartOfFrame(void) {
+	// The interrupt may land while USB_USBTask() has the control endpoint
+	// selected, so we put back whatever endpoint was selected before.
+	uint8_t PrevEndpoint = Endpoint_GetCurrentEndpoint();
+	usbFrame++;
+	if (USB_DeviceState == DEVICE_STATE_Configured && resync == NULL)
+		macroFrame++;
+	HID_Task();
+	Endpoint_SelectEndpoint(PrevEndpoint);
+}
+
+// Process and deliver data from IN and OUT endpoints.
+void HID_Task(void) {
+	// If the device isn't connected and properly configured, we can't do anything here.
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+		return;
+
+	// We'll start with the OUT endpoint.
+	Endpoint_SelectEndpoint(JOYSTICK_OUT_EPADDR);
+	// We'll check to see if we received something on the OUT endpoint.
+	// We're not doing anything with this data, so rather than reading it out we
+	// acknowledge the packet straight away, which frees the bank for the host.
+	// Only its timing matters, to pairController().
+	if (Endpoint_IsOUTReceived()) {
+		Endpoint_ClearOUT();
+		outReports++;
+		lastOutFrame = usbFrame;
+	}
+
+	// We'll then move on to the IN endpoint.
+	Endpoint_SelectEndpoint(JOYSTICK_IN_EPADDR);
+	// We first check to see if the host is ready to accept data.
+	if (Endpoint_IsINReady())
+	{
+		// The report for this poll was prepared after the last one, so the first
+		// thing we do is copy it into the endpoint bank and send it.
+		WriteReport(&nextReport);
+		Endpoint_ClearIN();
+		hostPolled = true;
+
+		measurePoll();
+		// Then we prepare the report for the host's next poll, which we expect
+		// one poll interval from now.
+		reportFrame = macroFrame + pollInterval;
+		GetNextReport(&nextReport);
+	}
+}
+
+typedef enum {
+	SYNC_CONTROLLER,
+	SYNC_POSITION,
+	BREATHE,
+	PROCESS,
+	CLEANUP,
+	DONE
+} State_t;
+State_t state = SYNC_CONTROLLER;
+
+// Move track tr on to its next command once the current one has run its
+// duration. Returns false if the track has nothing to play.
+static bool nextMove(track* tr) {
+	if (tr->active) {
+		// The current command ends once its time is up and the game has had
+		// a chance to see it.
+		if ((int16_t)(reportFrame - tr->end) < 0 || tr->polls < minPolls)
+			return true;
+		tr->active = false;
+	}
+
+	if (tr->tail != tr->head) {
+		PROFILE_TAKEN(tr == &tracks[TRACK_MAIN], true);
+		tr->move = tr->queue[tr->tail];
+		tr->tail = (tr->tail + 1) & (QUEUE_SIZE - 1);
+	} else if (tr->loop != NULL) {
+		if (pgm_read_byte(tr->loopNext) == OP_RETURN)
+			tr->loopNext = tr->loop;
+		tr->move.button = pgm_read_byte(tr->loopNext);
+		tr->move.duration = pgm_read_byte(tr->loopNext + 1);
+		tr->loopNext += 2;
+	} else {
+		// Nothing to play; the next command starts from now.
+		PROFILE_TAKEN(tr == &tracks[TRACK_MAIN], false);
+		tr->end = reportFrame;
+		return false;
+	}
+
+	// Commands are laid end to end on the frame timeline, so rounding to the
+	// poll interval doesn't add up over a run.
+	tr->end += FRAMES_TO_MS(tr->move.duration);
+	tr->polls = 0;
+	tr->active = true;
+	return true;
+}
+
+// Merge one track's input into report. Buttons add up; a stick axis takes
+// the first value that isn't centred.
+static void MergeReport(USB_JoystickReport_Input_t* const report, const USB_JoystickReport_Input_t* input) {
+	report->Button |= pgm_read_word(&input->Button);
+
+	uint8_t* axis = &report->LX;
+	const uint8_t* inputAxis = &input->LX;
+	uint8_t i;
+	for (i = 0; i < 4; i++) {
+		uint8_t value = pgm_read_byte(inputAxis + i);
+		if (axis[i] == STICK_CENTER)
+			axis[i] = value;
+	}
+}
+
+// Play the next input of resync into report, timed against the USB frames
+// as the macro clock is held. Clears resync once it has all been played.
+static void PlayResync(USB_JoystickReport_Input_t* const report) {
+	if ((int16_t)(usbFrame + pollInterval - resyncEnd) >= 0) {
+		if (pgm_read_byte(resync) == OP_RETURN) {
+			resync = NULL;
+			return;
+		}
+		resyncButton = pgm_read_byte(resync);
+		resyncEnd += FRAMES_TO_MS(pgm_read_byte(resync + 1));
+		resync += 2;
+	}
+	MergeReport(report, &reportTable[resyncButton]);
+}
+
+// Prepare the next report for the host.
+void GetNextReport(USB_JoystickReport_Input_t* const ReportData) {
+	// Start from a neutral controller.
+	memcpy_P(ReportData, &reportTable[NOTHING], sizeof(USB_JoystickReport_Input_t));
+
+	// States and moves management
+	switch (state)
+	{
+		case SYNC_CONTROLLER:
+			state = BREATHE;
+			break;
+
+		case SYNC_POSITION:
+			state = BREATHE;
+			break;
+
+		case BREATHE:
+			state = PROCESS;
+			break;
+
+		case PROCESS: {
+			uint8_t t;
+			if (resync != NULL) {
+				PlayResync(ReportData);
+				break;
+			}
+			for (t = 0; t < NUM_TRACKS; t++) {
+				if (!nextMove(&tracks[t]))
+					continue;
+				tracks[t].polls++;  // Used to check against minPolls
+				MergeReport(ReportData, &reportTable[tracks[t].move.button]);
+			}
+			break;
+		}
+
+		case CLEANUP:
+			state = DONE;
+			break;
+
+		case DONE:
+			#ifdef ALERT_WHEN_DONE
+			portsval = ~portsval;
+			PORTD = portsval; //flash LED(s) and sound buzzer if attached
+			PORTB = portsval;
+			_delay_ms(250);
+			#endif
+			break;
+	}
+}
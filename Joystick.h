@@ -1,155 +1,215 @@
-/*
-             LUFA Library
-     Copyright (C) Dean Camera, 2014.
-
-  dean [at] fourwalledcubicle [dot] com
-           www.lufa-lib.org
-*/
-
-/*
-  Copyright 2014  Dean Camera (dean [at] fourwalledcubicle [dot] com)
-
-  Permission to use, copy, modify, distribute, and sell this
-  software and its documentation for any purpose is hereby granted
-  without fee, provided that the above copyright notice appear in
-  all copies and that both that the copyright notice and this
-  permission notice and warranty disclaimer appear in supporting
-  documentation, and that the name of the author not be used in
-  advertising or publicity pertaining to distribution of the
-  software without specific, written prior permission.
-
-  The author disclaims all warranties with regard to this
-  software, including all implied warranties of merchantability
-  and fitness.  In no event shall the author be liable for any
-  special, indirect or consequential damages or any damages
-  whatsoever resulting from loss of use, data or profits, whether
-  in an action of contract, negligence or other tortious action,
-  arising out of or in connection with the use or performance of
-  this software.
-*/
-
-/** \file
- *
- *  Header file for Joystick.c.
- */
-
-#ifndef _JOYSTICK_H_
-#define _JOYSTICK_H_
-
-/* Includes: */
-#include <avr/io.h>
-#include <avr/wdt.h>
-#include <avr/power.h>
-#include <avr/interrupt.h>
-#include <avr/pgmspace.h>
-#include <string.h>
-
-#include <LUFA/Drivers/USB/USB.h>
-#include <LUFA/Drivers/Board/Joystick.h>
-#include <LUFA/Drivers/Board/LEDs.h>
-#include <LUFA/Drivers/Board/Buttons.h>
-#include <LUFA/Platform/Platform.h>
-
-#include "Descriptors.h"
-
-// Type Defines
-// Enumeration for joystick buttons.
-typedef enum {
-	SWITCH_Y       = 0x01,
-	SWITCH_B       = 0x02,
-	SWITCH_A       = 0x04,
-	SWITCH_X       = 0x08,
-	SWITCH_L       = 0x10,
-	SWITCH_R       = 0x20,
-	SWITCH_ZL      = 0x40,
-	SWITCH_ZR      = 0x80,
-	SWITCH_MINUS   = 0x100,
-	SWITCH_PLUS    = 0x200,
-	SWITCH_LCLICK  = 0x400,
-	SWITCH_RCLICK  = 0x800,
-	SWITCH_HOME    = 0x1000,
-	SWITCH_CAPTURE = 0x2000,
-} JoystickButtons_t;
-
-#define HAT_TOP          0x00
-#define HAT_TOP_RIGHT    0x01
-#define HAT_RIGHT        0x02
-#define HAT_BOTTOM_RIGHT 0x03
-#define HAT_BOTTOM       0x04
-#define HAT_BOTTOM_LEFT  0x05
-#define HAT_LEFT         0x06
-#define HAT_TOP_LEFT     0x07
-#define HAT_CENTER       0x08
-
-#define STICK_MIN      0
-#define STICK_CENTER 128
-#define STICK_MAX    255
-
-// Joystick HID report structure. We have an input and an output.
-typedef struct {
-	uint16_t Button; // 16 buttons; see JoystickButtons_t for bit mapping
-	uint8_t  HAT;    // HAT switch; one nibble w/ unused nibble
-	uint8_t  LX;     // Left  Stick X
-	uint8_t  LY;     // Left  Stick Y
-	uint8_t  RX;     // Right Stick X
-	uint8_t  RY;     // Right Stick Y
-	uint8_t  VendorSpec;
-} USB_JoystickReport_Input_t;
-
-// The output is structured as a mirror of the input.
-// This is based on initial observations of the Pokken Controller.
-typedef struct {
-	uint16_t Button; // 16 buttons; see JoystickButtons_t for bit mapping
-	uint8_t  HAT;    // HAT switch; one nibble w/ unused nibble
-	uint8_t  LX;     // Left  Stick X
-	uint8_t  LY;     // Left  Stick Y
-	uint8_t  RX;     // Right Stick X
-	uint8_t  RY;     // Right Stick Y
-} USB_JoystickReport_Output_t;
-
-typedef enum {
-	UP,
-	UPRIGHT,
-	DOWN,
-	LEFT,
-	RIGHT,
-	X,
-	Y,
-	A,
-	B,
-	L,
-	R,
-	THROW,
-	NOTHING,
-	PLUS,
-	MINUS,
-	TRIGGERS, 
-	SPIN, 
-	HOME 
-} Buttons_t;
-
-typedef struct {
-	Buttons_t button;
-	uint16_t duration;
-} command; 
-
-// Function Prototypes
-// Setup all necessary hardware, including USB initialization.
-void SetupHardware(void);
-// Process and deliver data from IN and OUT endpoints.
-void HID_Task(command move);
-// USB device event handlers.
-void EVENT_USB_Device_Connect(void);
-void EVENT_USB_Device_Disconnect(void);
-void EVENT_USB_Device_ConfigurationChanged(void);
-void EVENT_USB_Device_ControlRequest(void);
-void runCommand(command move);
-void runCommandList(command moves[]);
-// Prepare the next report for the host.
-void GetNextReport(USB_JoystickReport_Input_t* const ReportData, command move);
-
-//In game tasks
-void openBox(void);
-void selectColumn(void);
-void StorePokemon(int numcol);
-#endif
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2014.
+
+  dean [at] fourwalledcubicle [dot] com
+           www.lufa-lib.org
+*/
+
+/*
+  Copyright 2014  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting
+  documentation, and that the name of the author not be used in
+  advertising or publicity pertaining to distribution of the
+  software without specific, written prior permission.
+
+  The author disclaims all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for Joystick.c.
+ */
+
+#ifndef _JOYSTICK_H_
+#define _JOYSTICK_H_
+
+/* Includes: */
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <avr/power.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include <string.h>
+
+#include <LUFA/Drivers/USB/USB.h>
+#include <LUFA/Drivers/Board/Joystick.h>
+#include <LUFA/Drivers/Board/LEDs.h>
+#include <LUFA/Drivers/Board/Buttons.h>
+#include <LUFA/Platform/Platform.h>
+
+#include "Descriptors.h"
+#include "Settings.h"
+
+// Type Defines
+// Enumeration for joystick buttons.
+typedef enum {
+	SWITCH_Y       = 0x01,
+	SWITCH_B       = 0x02,
+	SWITCH_A       = 0x04,
+	SWITCH_X       = 0x08,
+	SWITCH_L       = 0x10,
+	SWITCH_R       = 0x20,
+	SWITCH_ZL      = 0x40,
+	SWITCH_ZR      = 0x80,
+	SWITCH_MINUS   = 0x100,
+	SWITCH_PLUS    = 0x200,
+	SWITCH_LCLICK  = 0x400,
+	SWITCH_RCLICK  = 0x800,
+	SWITCH_HOME    = 0x1000,
+	SWITCH_CAPTURE = 0x2000,
+} JoystickButtons_t;
+
+#define HAT_TOP          0x00
+#define HAT_TOP_RIGHT    0x01
+#define HAT_RIGHT        0x02
+#define HAT_BOTTOM_RIGHT 0x03
+#define HAT_BOTTOM       0x04
+#define HAT_BOTTOM_LEFT  0x05
+#define HAT_LEFT         0x06
+#define HAT_TOP_LEFT     0x07
+#define HAT_CENTER       0x08
+
+#define STICK_MIN      0
+#define STICK_CENTER 128
+#define STICK_MAX    255
+
+// Joystick HID report structure. We have an input and an output.
+typedef struct {
+	uint16_t Button; // 16 buttons; see JoystickButtons_t for bit mapping
+	uint8_t  HAT;    // HAT switch; one nibble w/ unused nibble
+	uint8_t  LX;     // Left  Stick X
+	uint8_t  LY;     // Left  Stick Y
+	uint8_t  RX;     // Right Stick X
+	uint8_t  RY;     // Right Stick Y
+	uint8_t  VendorSpec;
+} USB_JoystickReport_Input_t;
+
+// The output is structured as a mirror of the input.
+// This is based on initial observations of the Pokken Controller.
+typedef struct {
+	uint16_t Button; // 16 buttons; see JoystickButtons_t for bit mapping
+	uint8_t  HAT;    // HAT switch; one nibble w/ unused nibble
+	uint8_t  LX;     // Left  Stick X
+	uint8_t  LY;     // Left  Stick Y
+	uint8_t  RX;     // Right Stick X
+	uint8_t  RY;     // Right Stick Y
+} USB_JoystickReport_Output_t;
+
+typedef enum {
+	UP,
+	UPRIGHT,
+	DOWN,
+	LEFT,
+	RIGHT,
+	X,
+	Y,
+	A,
+	B,
+	L,
+	R,
+	THROW,
+	NOTHING,
+	PLUS,
+	MINUS,
+	TRIGGERS, 
+	SPIN, 
+	HOME 
+} Buttons_t;
+
+typedef struct {
+	Buttons_t button;
+	uint16_t duration; // in game frames
+} command; 
+
+// Tracks that play at the same time and are merged into each report.
+// Sequences play on TRACK_MAIN, which carries the left-stick trajectory and
+// everything else that has to happen in order; the others are for inputs
+// that can overlap it, like mashing B while walking.
+typedef enum {
+	TRACK_MAIN,
+	TRACK_BUTTONS,
+	TRACK_RIGHT_STICK,
+	NUM_TRACKS
+} Track_t;
+
+// Timing
+// The game runs at 60 frames per second. USB frames are 1ms.
+#define FRAME_RATE       60
+#define FRAMES_TO_MS(f)  ((uint16_t)(((uint32_t)(f) * 1000 + FRAME_RATE / 2) / FRAME_RATE))
+#define MS_TO_FRAMES(ms) ((uint16_t)(((uint32_t)(ms) * FRAME_RATE + 999) / 1000))
+// Polls needed for a report to span a whole game frame at a given poll interval.
+#define MIN_POLLS(pollMs) ((1000 + FRAME_RATE * (pollMs) - 1) / (FRAME_RATE * (pollMs)))
+
+#include "Sequence.h"
+#include "Box.h"
+#include "Checkpoint.h"
+#include "Profile.h"
+
+// Ids of the sequences in the sequences[] table, for use with CALL().
+typedef enum {
+	SEQ_RUN,
+	SEQ_OPEN_BOX,
+	SEQ_OPEN_BOX_MULTIPURPOSE,
+	SEQ_OPEN_BOX_NORMAL,
+	SEQ_RELEASE,
+	SEQ_RELEASE_DIALOGUE,
+	SEQ_CLOSE_MENUS,
+	SEQ_CLOSE_BOX,
+	SEQ_MASH_B,
+	SEQ_MASH_A,
+	SEQ_HATCH_PARTY
+} Sequence_t;
+
+// Function Prototypes
+// Setup all necessary hardware, including USB initialization.
+void SetupHardware(void);
+// Process and deliver data from IN and OUT endpoints.
+void HID_Task(void);
+// USB device event handlers.
+void EVENT_USB_Device_Connect(void);
+void EVENT_USB_Device_Disconnect(void);
+void EVENT_USB_Device_Reset(void);
+void EVENT_USB_Device_Suspend(void);
+void EVENT_USB_Device_WakeUp(void);
+void EVENT_USB_Device_ConfigurationChanged(void);
+void EVENT_USB_Device_ControlRequest(void);
+void EVENT_USB_Device_StartOfFrame(void);
+// Queue a command to be reported from the Start-of-Frame interrupt.
+void runCommand(command move);
+void runCommandOn(uint8_t t, command move);
+// Loop a sequence on a track whenever it has nothing queued, and stop it.
+void startBackground(uint8_t t, const uint8_t* seq);
+void stopBackground(uint8_t t);
+// Wait until every queued command has been reported.
+void flushCommands(void);
+// Sleep until the next interrupt while servicing the USB stack.
+void idle(void);
+// Prepare the next report for the host.
+void GetNextReport(USB_JoystickReport_Input_t* const ReportData);
+
+//In game tasks
+void pairController(void);
+void collect(void);
+void storeParty(void);
+void collectAndHatch(uint16_t egg);
+uint16_t restoreCollection(uint16_t eggs, uint8_t held);
+void hatch(uint8_t box, uint8_t col, bool holding);
+void release(uint8_t from, uint8_t slots, uint8_t boxes);
+uint8_t hatchPasses(void);
+uint8_t pipelinePasses(void);
+#endif
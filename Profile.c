@@ -0,0 +1,48 @@
+#ifdef PROFILE
+
+#include "Joystick.h"
+
+// Marks waiting for the main track to reach them, each with the number of
+// main track inputs queued before it.
+#define MARK_QUEUE_SIZE 32
+static volatile uint8_t marks[MARK_QUEUE_SIZE];
+static volatile uint16_t markAt[MARK_QUEUE_SIZE];
+static volatile uint8_t markHead = 0;
+static volatile uint8_t markTail = 0;
+// Main track inputs queued, counted by main(), and taken, by the interrupt.
+static uint16_t queued = 0;
+static uint16_t taken = 0;
+
+void profileMark(uint8_t mark) {
+	uint8_t next = (markHead + 1) & (MARK_QUEUE_SIZE - 1);
+	while (next == markTail)
+		idle();
+
+	marks[markHead] = mark;
+	markAt[markHead] = queued;
+	markHead = next;
+}
+
+void profileQueued(void) {
+	queued++;
+}
+
+void profileTaken(bool move) {
+	while (markTail != markHead && markAt[markTail] == taken) {
+		profileRecord(marks[markTail]);
+		markTail = (markTail + 1) & (MARK_QUEUE_SIZE - 1);
+	}
+	if (move)
+		taken++;
+}
+
+void profileEnd(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		while (markTail != markHead) {
+			profileRecord(marks[markTail]);
+			markTail = (markTail + 1) & (MARK_QUEUE_SIZE - 1);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+// Phase markers. A normal build compiles every marker to nothing. A profile
+// build (the host build, which defines PROFILE) records each marker as the
+// main track reaches it in playback, not as main() passes it, so a phase
+// runs from the report its first input goes out in to the report after its
+// last. Markers don't take room in the command queue, so a profiled job
+// plays exactly as an unprofiled one. host/profile.py turns the record into
+// a breakdown of where the time went.
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Type Defines
+// Phases, named in the breakdown after their identifiers. Phases nest.
+typedef enum {
+	PHASE_PAIR,            // pairController()
+	PHASE_COLLECT,         // one egg collected, and stored if the party is full
+	PHASE_WALK,            // walking the bridge for the next egg
+	PHASE_DAY_CARE,        // taking the egg from the day care lady
+	PHASE_STORE,           // storeParty()
+	PHASE_RETURN,          // back to the first box after collecting
+	PHASE_HATCH,           // hatch()
+	PHASE_HATCH_WALK,      // walking until the party has hatched
+	PHASE_RELEASE,         // release()
+	PHASE_RELEASE_SLOT,    // boxRelease()
+	PHASE_OPEN_BOX,        // openBox() and friends
+	PHASE_CLOSE_MENUS,     // mashing B out of the box or menus
+	PHASE_MOVE_CURSOR,     // boxMoveTo()
+	PHASE_SELECT,          // changing box mode and grabbing
+	PHASE_NEXT_BOX,        // boxNextBox() and boxPrevBox()
+	NUM_PHASES
+} Phase_t;
+
+// Marks as recorded. 0 is never a mark.
+#define PROFILE_ENTER_MARK(phase) (0x40 | (phase))
+#define PROFILE_EXIT_MARK(phase)  (0x80 | (phase))
+
+#ifdef PROFILE
+
+// Function Prototypes
+void profileMark(uint8_t mark);
+// Called by the interrupt as the main track takes its next input (move) or
+// runs out of input.
+void profileTaken(bool move);
+// Counts an input queued on the main track.
+void profileQueued(void);
+// Records the marks left once the job has played out, which all come at its end.
+void profileEnd(void);
+// Records a mark as it comes up in playback. Provided by the platform.
+void profileRecord(uint8_t mark);
+
+#define PROFILE_ENTER(phase)      profileMark(PROFILE_ENTER_MARK(phase))
+#define PROFILE_EXIT(phase)       profileMark(PROFILE_EXIT_MARK(phase))
+#define PROFILE_QUEUED(t)         do { if ((t) == TRACK_MAIN) profileQueued(); } while (0)
+#define PROFILE_TAKEN(main, move) do { if (main) profileTaken(move); } while (0)
+#define PROFILE_END()             profileEnd()
+
+#else
+
+#define PROFILE_ENTER(phase)
+#define PROFILE_EXIT(phase)
+#define PROFILE_QUEUED(t)
+#define PROFILE_TAKEN(main, move)
+#define PROFILE_END()
+
+#endif
+
+#endif
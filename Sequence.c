@@ -0,0 +1,114 @@
+#include "Joystick.h"
+
+uint8_t seqVar[NUM_VARS];
+
+// Returns the address just past the NEXT that closes the loop whose body
+// starts at seq. Used when a loop runs zero times.
+static const uint8_t* skipLoop(const uint8_t* seq) {
+	uint8_t depth = 1;
+	for (;;) {
+		uint8_t op = pgm_read_byte(seq++);
+		switch (op) {
+			case OP_REPEAT:
+				seq += 1;
+				depth++;
+				break;
+			case OP_CALL:
+			case OP_TRACK:
+			case OP_STOP:
+				seq += 1;
+				break;
+			case OP_BACKGROUND:
+				seq += 2;
+				break;
+			case OP_SYNC:
+				break;
+			case OP_REPEAT_VAR:
+				seq += 2;
+				depth++;
+				break;
+			case OP_NEXT:
+				if (--depth == 0)
+					return seq;
+				break;
+			case OP_RETURN:
+				// Unbalanced loop; stop at the end of the sequence.
+				return seq - 1;
+			default:
+				// A press carries its duration.
+				seq += 1;
+				break;
+		}
+	}
+}
+
+void runSequence(const uint8_t* seq) {
+	const uint8_t* loopStart[SEQ_MAX_DEPTH];
+	uint8_t loopCount[SEQ_MAX_DEPTH];
+	uint8_t depth = 0;
+	uint8_t count;
+	uint8_t track = TRACK_MAIN;
+
+	for (;;) {
+		uint8_t op = pgm_read_byte(seq++);
+		switch (op) {
+			case OP_REPEAT:
+				count = pgm_read_byte(seq++);
+				goto startLoop;
+
+			case OP_REPEAT_VAR:
+				count = seqVar[pgm_read_byte(seq)] + pgm_read_byte(seq + 1);
+				seq += 2;
+			startLoop:
+				if (count == 0) {
+					seq = skipLoop(seq);
+				} else {
+					loopStart[depth] = seq;
+					loopCount[depth] = count;
+					depth++;
+				}
+				break;
+
+			case OP_NEXT:
+				if (--loopCount[depth - 1] != 0)
+					seq = loopStart[depth - 1];
+				else
+					depth--;
+				break;
+
+			case OP_CALL:
+				runSequenceId(pgm_read_byte(seq++));
+				break;
+
+			case OP_TRACK:
+				track = pgm_read_byte(seq++);
+				break;
+
+			case OP_BACKGROUND:
+				startBackground(pgm_read_byte(seq), pgm_read_ptr(&sequences[pgm_read_byte(seq + 1)]));
+				seq += 2;
+				break;
+
+			case OP_STOP:
+				stopBackground(pgm_read_byte(seq++));
+				break;
+
+			case OP_SYNC:
+				flushCommands();
+				break;
+
+			case OP_RETURN:
+				return;
+
+			default: {
+				command move = { (Buttons_t)op, pgm_read_byte(seq++) };
+				runCommandOn(track, move);
+				break;
+			}
+		}
+	}
+}
+
+void runSequenceId(uint8_t id) {
+	runSequence(pgm_read_ptr(&sequences[id]));
+}
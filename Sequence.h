@@ -0,0 +1,77 @@
+#ifndef _SEQUENCE_H_
+#define _SEQUENCE_H_
+
+// Includes
+#include <stdint.h>
+
+#include <avr/pgmspace.h>
+
+// Input sequences are stored in flash as a small bytecode and played back by
+// runSequence(). A press is two bytes: the Buttons_t value followed by its
+// duration. Every other instruction starts with an opcode from the range
+// below, which is far above the last Buttons_t value.
+//
+//   PRESS(A, 5), WAIT(10),          hold A for 5, then release for 10
+//   REPEAT(13), ..., NEXT,          run the body 13 times
+//   REPEAT_VAR(VAR_ROW, 0), NEXT,   run the body seqVar[VAR_ROW] + 0 times
+//   CALL(SEQ_OPEN_BOX),             run another sequence, then carry on
+//   TRACK(TRACK_BUTTONS),           queue the following presses on a track
+//   BACKGROUND(TRACK_BUTTONS, id),  loop a sequence on a track while it is idle
+//   STOP(TRACK_BUTTONS),            end a track's background loop
+//   SYNC,                           wait for every track to catch up
+//   RETURN                          end of the sequence
+// A sequence starts out on TRACK_MAIN. Background sequences may only hold
+// presses and waits.
+typedef enum {
+	OP_REPEAT     = 0xF0,
+	OP_REPEAT_VAR = 0xF1,
+	OP_NEXT       = 0xF2,
+	OP_CALL       = 0xF3,
+	OP_TRACK      = 0xF4,
+	OP_BACKGROUND = 0xF5,
+	OP_STOP       = 0xF6,
+	OP_SYNC       = 0xF7,
+	OP_RETURN     = 0xFF
+} Opcode_t;
+
+// Bytecode Macros
+#define PRESS(button, duration) (button), (duration)
+#define WAIT(duration)          NOTHING, (duration)
+#define REPEAT(count)           OP_REPEAT, (count)
+#define REPEAT_VAR(var, bias)   OP_REPEAT_VAR, (var), (uint8_t)(bias)
+#define NEXT                    OP_NEXT
+#define CALL(id)                OP_CALL, (id)
+#define TRACK(t)                OP_TRACK, (t)
+#define BACKGROUND(t, id)       OP_BACKGROUND, (t), (id)
+#define STOP(t)                 OP_STOP, (t)
+#define SYNC                    OP_SYNC
+#define RETURN                  OP_RETURN
+
+// How deep REPEAT blocks may be nested inside a single sequence.
+#define SEQ_MAX_DEPTH 4
+
+// Counters that REPEAT_VAR can read. The macro code also keeps its progress
+// through the job here.
+typedef enum {
+	VAR_ROW,
+	VAR_COLUMN,
+	VAR_BOXES_FORWARD,
+	VAR_COLLECT_PASSES,
+	VAR_HATCH_PASSES,
+	VAR_PARTY_SLOT,
+	VAR_PARTY_EGGS,
+	NUM_VARS
+} SequenceVar_t;
+
+extern uint8_t seqVar[NUM_VARS];
+
+// Table of callable sequences, indexed by the id given to CALL().
+extern const uint8_t* const sequences[] PROGMEM;
+
+// Function Prototypes
+// Play a flash-resident sequence until its RETURN.
+void runSequence(const uint8_t* seq);
+// Play the sequence registered under id in sequences[].
+void runSequenceId(uint8_t id);
+
+#endif
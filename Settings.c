@@ -0,0 +1,44 @@
+#include "Joystick.h"
+
+#include <stddef.h>
+#include <util/crc16.h>
+
+// Built-in defaults, from Settings.h.
+Settings_t settings = {
+	.version       = SETTINGS_VERSION,
+	.mode          = DEFAULT_MODE,
+	.eggsToCollect = DEFAULT_EGGS,
+	.boxesToHatch  = DEFAULT_BOXES,
+	.numBoxes      = DEFAULT_RELEASE_BOXES,
+	.collectPasses = DEFAULT_COLLECT_PASSES,
+	.hatchPasses   = DEFAULT_HATCH_PASSES,
+	.eggCycles     = DEFAULT_CYCLES,
+	.flameBody     = DEFAULT_FLAME_BODY,
+	.releaseHatched = DEFAULT_RELEASE_HATCHED,
+	.keepSlots     = { DEFAULT_KEEP_SLOTS },
+	.hatchColumns  = DEFAULT_HATCH_COLUMNS
+};
+
+#ifdef CFG_FIXED
+// Rows kept in each column by a fixed build, from KEEP_SLOTS.
+const uint8_t keepSlots[BOX_COLUMNS] PROGMEM = { CFG_KEEP_SLOTS };
+#endif
+
+bool loadSettings(void) {
+	Settings_t stored;
+	eeprom_read_block(&stored, (const void*)SETTINGS_ADDRESS, sizeof(stored));
+
+	if (stored.version != SETTINGS_VERSION)
+		return false;
+
+	uint8_t crc = 0;
+	const uint8_t* data = (const uint8_t*)&stored;
+	uint8_t i;
+	for (i = 0; i < offsetof(Settings_t, crc); i++)
+		crc = _crc_ibutton_update(crc, data[i]);
+	if (crc != stored.crc)
+		return false;
+
+	settings = stored;
+	return true;
+}
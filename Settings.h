@@ -0,0 +1,139 @@
+#ifndef _SETTINGS_H_
+#define _SETTINGS_H_
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <avr/eeprom.h>
+
+#include "Box.h"
+
+// Type Defines
+typedef enum {
+	COLLECTING,
+	COLLECT_THEN_HATCH,
+	HATCHING,
+	RELEASING,
+	// Retired, and do nothing. Kept so that the modes after them keep their
+	// numbers in EEPROM.
+	RAIDRESETTING,
+	FLY,
+	COLLECT_AND_HATCH
+} Modes;
+
+// Parameter block read from the start of EEPROM at boot, so that a unit can
+// be switched between jobs by writing its EEPROM instead of rebuilding and
+// reflashing. eepconfig.py writes this block into a .eep image; keep the two
+// in step and bump SETTINGS_VERSION whenever the layout changes.
+typedef struct {
+	uint8_t  version;
+	uint8_t  mode;           // Modes
+	// Separate settings are used across COLLECTING and HATCHING modes to make
+	// them individually configurable. When using COLLECT_THEN_HATCH, the
+	// hatching params will be overridden by the collecting params.
+	uint16_t eggsToCollect;
+	// We hatch in columns, which are 5 eggs at a time. HATCHING hatches the
+	// columns set in hatchColumns of each of boxesToHatch boxes.
+	uint8_t  boxesToHatch;
+	// Boxes to clear when RELEASING.
+	uint8_t  numBoxes;
+	// Passes of run[] between visits to the day care lady. The fewer passes,
+	// the more quickly you'll get eggs with some error rate in eggs not being
+	// ready. COLLECT_AND_HATCH walks further if its party eggs need it.
+	uint8_t  collectPasses;
+	// Passes of run[] taken to hatch a column before waiting on the hatches.
+	// 0 works it out from eggCycles and flameBody.
+	uint8_t  hatchPasses;
+	// Egg cycles of the species being hatched (5 to 40), and whether a
+	// pokemon with Flame Body or Magma Armor is in the party, halving them.
+	uint8_t  eggCycles;
+	uint8_t  flameBody;
+	// Whether hatch() releases each column once it is back in the box, and
+	// the rows of each column to keep when it does (bit r keeps row r).
+	uint8_t  releaseHatched;
+	uint8_t  keepSlots[BOX_COLUMNS];
+	uint8_t  hatchColumns;
+	// CRC-8 (Dallas/iButton) of every byte above.
+	uint8_t  crc;
+} Settings_t;
+
+#define SETTINGS_VERSION 4
+// EEPROM address of the parameter block.
+#define SETTINGS_ADDRESS 0
+
+// Built-in defaults, used when the EEPROM holds no valid parameter block.
+#define DEFAULT_MODE           HATCHING
+#define DEFAULT_EGGS           30
+#define DEFAULT_BOXES          8
+#define DEFAULT_RELEASE_BOXES  4
+#define DEFAULT_COLLECT_PASSES 6
+#define DEFAULT_HATCH_PASSES   0
+#define DEFAULT_CYCLES         20
+#define DEFAULT_FLAME_BODY     1
+#define DEFAULT_RELEASE_HATCHED 0
+#define DEFAULT_KEEP_SLOTS     0, 0, 0, 0, 0, 0
+#define DEFAULT_HATCH_COLUMNS  0x3F
+
+extern Settings_t settings;
+
+// The job can instead be fixed when building, e.g.
+// `make MODE=HATCHING BOXES=8 CYCLES=20`. The parameters then become
+// constants, so loop bounds fold and the routines of the other modes are
+// left out of the image. Parameters not given keep the built-in defaults,
+// and the EEPROM isn't read. The code reads every parameter through these
+// CFG_* names.
+#ifdef CFG_MODE
+#define CFG_FIXED
+#ifndef CFG_EGGS
+#define CFG_EGGS           DEFAULT_EGGS
+#endif
+#ifndef CFG_BOXES
+#define CFG_BOXES          DEFAULT_BOXES
+#endif
+#ifndef CFG_RELEASE_BOXES
+#define CFG_RELEASE_BOXES  DEFAULT_RELEASE_BOXES
+#endif
+#ifndef CFG_COLLECT_PASSES
+#define CFG_COLLECT_PASSES DEFAULT_COLLECT_PASSES
+#endif
+#ifndef CFG_HATCH_PASSES
+#define CFG_HATCH_PASSES   DEFAULT_HATCH_PASSES
+#endif
+#ifndef CFG_CYCLES
+#define CFG_CYCLES         DEFAULT_CYCLES
+#endif
+#ifndef CFG_FLAME_BODY
+#define CFG_FLAME_BODY     DEFAULT_FLAME_BODY
+#endif
+#ifndef CFG_RELEASE_HATCHED
+#define CFG_RELEASE_HATCHED DEFAULT_RELEASE_HATCHED
+#endif
+#ifndef CFG_HATCH_COLUMNS
+#define CFG_HATCH_COLUMNS  DEFAULT_HATCH_COLUMNS
+#endif
+#ifndef CFG_KEEP_SLOTS
+#define CFG_KEEP_SLOTS     DEFAULT_KEEP_SLOTS
+#endif
+extern const uint8_t keepSlots[BOX_COLUMNS] PROGMEM;
+#define CFG_KEEP(col)      pgm_read_byte(&keepSlots[col])
+#else
+#define CFG_MODE           ((Modes)settings.mode)
+#define CFG_EGGS           settings.eggsToCollect
+#define CFG_BOXES          settings.boxesToHatch
+#define CFG_RELEASE_BOXES  settings.numBoxes
+#define CFG_COLLECT_PASSES settings.collectPasses
+#define CFG_HATCH_PASSES   settings.hatchPasses
+#define CFG_CYCLES         settings.eggCycles
+#define CFG_FLAME_BODY     settings.flameBody
+#define CFG_RELEASE_HATCHED settings.releaseHatched
+#define CFG_KEEP(col)      settings.keepSlots[col]
+#define CFG_HATCH_COLUMNS  settings.hatchColumns
+#endif
+
+// Function Prototypes
+// Load the parameter block from EEPROM, keeping the built-in defaults if it
+// is blank, from another version or corrupt. Returns true if it was loaded.
+bool loadSettings(void);
+
+#endif
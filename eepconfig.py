@@ -0,0 +1,147 @@
+#!/bin/python
+
+import sys, getopt, struct
+
+# Must match Modes and Settings_t in Settings.h.
+MODES = ["COLLECTING", "COLLECT_THEN_HATCH", "HATCHING", "RELEASING", "RAIDRESETTING", "FLY", "COLLECT_AND_HATCH"]
+# Modes that no longer do anything, kept in MODES for their numbers.
+RETIRED_MODES = ["RAIDRESETTING", "FLY"]
+SETTINGS_VERSION = 4
+SETTINGS_ADDRESS = 0
+# Checkpoint ring from Checkpoint.h, blanked so that new settings start a new job.
+CHECKPOINT_ADDRESS = 32
+CHECKPOINT_SIZE = 8
+CHECKPOINT_SLOTS = 16
+
+# Built-in defaults from Settings.h.
+DEFAULTS = {
+  "mode": "HATCHING",
+  "eggsToCollect": 30,
+  "boxesToHatch": 8,
+  "numBoxes": 4,
+  "collectPasses": 6,
+  "hatchPasses": 0,
+  "eggCycles": 20,
+  "flameBody": 1,
+  "releaseHatched": 0,
+  "keepSlots": [0, 0, 0, 0, 0, 0],
+  "hatchColumns": 0x3F,
+}
+
+OPTIONS = {
+  "-m": "mode",
+  "-e": "eggsToCollect",
+  "-b": "boxesToHatch",
+  "-n": "numBoxes",
+  "-c": "collectPasses",
+  "-p": "hatchPasses",
+  "-y": "eggCycles",
+  "-f": "flameBody",
+  "-r": "releaseHatched",
+  "-l": "hatchColumns",
+}
+
+def crc8(data):
+  # Dallas/iButton CRC-8, as _crc_ibutton_update() in avr-libc.
+  crc = 0
+  for byte in bytearray(data):
+    crc ^= byte
+    for i in range(8):
+      if crc & 0x01:
+        crc = (crc >> 1) ^ 0x8C
+      else:
+        crc >>= 1
+  return crc
+
+def pack(settings):
+  block = struct.pack("<BBHBBBBBBB6BB",
+    SETTINGS_VERSION,
+    MODES.index(settings["mode"]),
+    settings["eggsToCollect"],
+    settings["boxesToHatch"],
+    settings["numBoxes"],
+    settings["collectPasses"],
+    settings["hatchPasses"],
+    settings["eggCycles"],
+    settings["flameBody"],
+    settings["releaseHatched"],
+    *(settings["keepSlots"] + [settings["hatchColumns"]]))
+  return block + struct.pack("<B", crc8(block))
+
+def intelHex(data, address):
+  lines = []
+  for offset in range(0, len(data), 16):
+    chunk = bytearray(data[offset:offset + 16])
+    record = bytearray([len(chunk), (address + offset) >> 8, (address + offset) & 0xFF, 0x00]) + chunk
+    checksum = (-sum(record)) & 0xFF
+    lines.append(":" + "".join("%02X" % b for b in record) + "%02X" % checksum)
+  lines.append(":00000001FF")
+  return "\n".join(lines) + "\n"
+
+def main(argv):
+  opts, args = getopt.getopt(argv, "hm:e:b:n:c:p:y:f:r:k:l:o:s")
+
+  settings = dict(DEFAULTS)
+  output = "Joystick.eep"
+  startOver = False
+  for opt, arg in opts:
+    if opt == '-h':
+      usage()
+      sys.exit()
+    elif opt == '-o':
+      output = arg
+    elif opt == '-s':
+      startOver = True
+    elif opt == '-m':
+      if arg.upper() not in MODES or arg.upper() in RETIRED_MODES:
+        modes = [mode for mode in MODES if mode not in RETIRED_MODES]
+        print("ERROR: Unknown mode {}, expected one of {}".format(arg, ", ".join(modes)))
+        sys.exit(1)
+      settings["mode"] = arg.upper()
+    elif opt == '-k':
+      masks = [int(mask, 0) for mask in arg.split(",")]
+      if len(masks) != 6:
+        print("ERROR: Expected 6 row masks, one per column, got {}".format(arg))
+        sys.exit(1)
+      settings["keepSlots"] = masks
+    else:
+      settings[OPTIONS[opt]] = int(arg, 0)
+
+  if startOver:
+    with open(output, 'w') as f:
+      f.write(intelHex(b"\xff" * (CHECKPOINT_SLOTS * CHECKPOINT_SIZE), CHECKPOINT_ADDRESS))
+    print("Checkpoints blanked in {}; the settings are left as they are.".format(output))
+    return
+
+  with open(output, 'w') as f:
+    block = pack(settings)
+    blank = CHECKPOINT_ADDRESS + CHECKPOINT_SLOTS * CHECKPOINT_SIZE - SETTINGS_ADDRESS - len(block)
+    f.write(intelHex(block + b"\xff" * blank, SETTINGS_ADDRESS))
+
+  print("Settings saved to {}:".format(output))
+  for key in ["mode", "eggsToCollect", "boxesToHatch", "numBoxes", "collectPasses", "hatchPasses", "eggCycles", "flameBody", "releaseHatched", "keepSlots", "hatchColumns"]:
+    print("  {} = {}".format(key, settings[key]))
+
+def usage():
+  print("To write the EEPROM settings block: eepconfig.py [options]")
+  print("  -m mode           COLLECTING, COLLECT_THEN_HATCH, HATCHING,")
+  print("                    COLLECT_AND_HATCH or RELEASING")
+  print("  -e eggsToCollect  eggs to collect from the day care lady")
+  print("  -b boxesToHatch   boxes to hatch")
+  print("  -l hatchColumns   columns of each box holding eggs, as a mask with bit c")
+  print("                    for column c (default 0x3F, all six)")
+  print("  -n numBoxes       boxes to release")
+  print("  -c collectPasses  passes of the bridge between eggs")
+  print("  -p hatchPasses    passes of the bridge to hatch a column (0 works it out)")
+  print("  -y eggCycles      egg cycles of the species being hatched")
+  print("  -f flameBody      1 if Flame Body or Magma Armor is in the party, else 0")
+  print("  -r releaseHatched 1 to release each hatched column while the box is open")
+  print("  -k keepSlots      rows to keep when releasing hatched columns, as 6 masks,")
+  print("                    one per column, with bit r for row r (e.g. 0x1,0,0,0,0,0)")
+  print("  -s                blank only the saved progress, so that the job in the")
+  print("                    EEPROM or built into the image starts over")
+  print("  -o file           output file (default Joystick.eep)")
+  print("Then flash it with: sudo dfu-programmer atmega16u2 flash --eeprom Joystick.eep")
+
+if __name__ == "__main__":
+  main(sys.argv[1:])
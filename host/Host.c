@@ -0,0 +1,347 @@
+/*
+Host build of the firmware.
+
+Joystick.c and the rest of the firmware are compiled unchanged for the host,
+against the stand-in headers under include/. This file plays the USB host:
+every call to sleep_mode() lets one 1ms USB frame go by, fires the
+Start-of-Frame event and offers the IN endpoint at the poll interval. Every
+report sent is written to a trace with the frame it went out in, so a whole
+job runs in well under a second and can be timed before anything is flashed.
+
+	make && ./Joystick -e ../Joystick.eep -o hatch.trace
+*/
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Joystick.h"
+
+// The firmware's main(), renamed by the makefile.
+int FirmwareMain(void);
+
+#define EEPROM_SIZE 512
+
+uint8_t MCUSR, DDRB, PORTB, DDRD, PORTD;
+volatile uint8_t USB_DeviceState = DEVICE_STATE_Unattached;
+
+static uint8_t eeprom[EEPROM_SIZE];
+
+// Emulated host.
+static unsigned long long frame = 0;
+static unsigned long long frameLimit = 100000000ULL;
+static unsigned hostPoll = 8;
+static bool sofEnabled = false;
+static uint8_t endpoint = 0;
+static bool inReady = false;
+// OUT reports are sent every 16 frames between these frames.
+static unsigned long long outFrom = 0, outUntil = 0;
+// The bus is suspended or reset for busLength frames from busAt.
+static char busEvent = 0;
+static unsigned long long busAt = 0, busLength = 0;
+// The power is cut at this frame, if not 0.
+static unsigned long long cutAt = 0;
+
+// Report stream.
+static uint8_t report[sizeof(USB_JoystickReport_Input_t)];
+static uint8_t lastReport[sizeof(USB_JoystickReport_Input_t)];
+static uint8_t reportLength = 0;
+static unsigned long long reports = 0, changes = 0;
+static unsigned long long hash = 14695981039346656037ULL;
+static FILE* trace = NULL;
+static FILE* checkpoints = NULL;
+static FILE* marks = NULL;
+static FILE* keys = NULL;
+static unsigned long keyInterval = 65536;
+static bool changesOnly = false;
+static const char* eepromOut = NULL;
+
+// EEPROM
+void eeprom_read_block(void* dst, const void* src, size_t n) {
+	memcpy(dst, &eeprom[(uintptr_t)src], n);
+}
+
+void eeprom_update_block(const void* src, void* dst, size_t n) {
+	uintptr_t address = (uintptr_t)dst;
+	memcpy(&eeprom[address], src, n);
+
+	// A checkpoint marks the end of a stretch of the job.
+	if (checkpoints != NULL && n == sizeof(Checkpoint_t) && address >= CHECKPOINT_ADDRESS
+			&& address < CHECKPOINT_ADDRESS + CHECKPOINT_SLOTS * sizeof(Checkpoint_t)) {
+		const Checkpoint_t* cp = src;
+		fprintf(checkpoints, "%llu %u %u %u %u\n", frame, cp->phase, cp->count, cp->box, cp->col);
+	}
+}
+
+// Read the data records of an Intel HEX file, as written by eepconfig.py.
+static bool readHex(const char* path, uint8_t* image, size_t size) {
+	FILE* f = fopen(path, "r");
+	char line[600];
+	if (f == NULL)
+		return false;
+	while (fgets(line, sizeof(line), f)) {
+		unsigned count, address, type, byte, i;
+		if (sscanf(line, ":%2x%4x%2x", &count, &address, &type) != 3)
+			continue;
+		if (type != 0)
+			continue;
+		for (i = 0; i < count && address + i < size; i++) {
+			sscanf(line + 9 + i * 2, "%2x", &byte);
+			image[address + i] = byte;
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+static void writeHex(const char* path, const uint8_t* image, size_t size) {
+	FILE* f = fopen(path, "w");
+	size_t offset, i;
+	if (f == NULL)
+		return;
+	for (offset = 0; offset < size; offset += 16) {
+		uint8_t sum = 16 + (offset >> 8) + (offset & 0xFF);
+		fprintf(f, ":10%04X00", (unsigned)offset);
+		for (i = 0; i < 16; i++) {
+			fprintf(f, "%02X", image[offset + i]);
+			sum += image[offset + i];
+		}
+		fprintf(f, "%02X\n", (uint8_t)-sum);
+	}
+	fprintf(f, ":00000001FF\n");
+	fclose(f);
+}
+
+// USB device API
+void USB_Init(void) {
+	USB_DeviceState = DEVICE_STATE_Configured;
+	EVENT_USB_Device_Connect();
+	EVENT_USB_Device_ConfigurationChanged();
+}
+
+void USB_USBTask(void) {
+}
+
+void USB_Device_EnableSOFEvents(void) {
+	sofEnabled = true;
+}
+
+void GlobalInterruptEnable(void) {
+}
+
+bool Endpoint_ConfigureEndpoint(uint8_t address, uint8_t type, uint16_t size, uint8_t banks) {
+	return true;
+}
+
+uint8_t Endpoint_GetCurrentEndpoint(void) {
+	return endpoint;
+}
+
+void Endpoint_SelectEndpoint(uint8_t address) {
+	endpoint = address;
+}
+
+bool Endpoint_IsOUTReceived(void) {
+	return !(endpoint & ENDPOINT_DIR_IN) && frame >= outFrom && frame < outUntil && frame % 16 == 0;
+}
+
+void Endpoint_ClearOUT(void) {
+}
+
+bool Endpoint_IsINReady(void) {
+	return (endpoint & ENDPOINT_DIR_IN) && inReady;
+}
+
+void Endpoint_Write_8(uint8_t data) {
+	if (reportLength < sizeof(report))
+		report[reportLength++] = data;
+}
+
+// The host has taken the report in the IN bank.
+void Endpoint_ClearIN(void) {
+	uint8_t i;
+	bool changed = memcmp(report, lastReport, sizeof(report)) != 0;
+
+	inReady = false;
+	reportLength = 0;
+	reports++;
+	if (changed)
+		changes++;
+	// FNV-1a over the frame and the report, so that equal hashes mean equal
+	// timelines.
+	for (i = 0; i < 8; i++)
+		hash = (hash ^ ((frame >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+	for (i = 0; i < sizeof(report); i++)
+		hash = (hash ^ report[i]) * 1099511628211ULL;
+
+	if (trace != NULL && (changed || !changesOnly)) {
+		const USB_JoystickReport_Input_t* r = (const USB_JoystickReport_Input_t*)report;
+		fprintf(trace, "%llu %04x %x %u %u %u %u\n", frame,
+			r->Button, r->HAT, r->LX, r->LY, r->RX, r->RY);
+	}
+	if (keys != NULL && reports % keyInterval == 0)
+		fprintf(keys, "%llu %llu %016llx\n", reports, frame, hash);
+	memcpy(lastReport, report, sizeof(report));
+}
+
+// Profile
+// The mark comes up as the next report is made, so it is stamped with the
+// frame that report goes out in and the reports sent before it.
+void profileRecord(uint8_t mark) {
+	if (marks != NULL)
+		fprintf(marks, "%llu %llu %u\n", frame + hostPoll, reports, mark);
+}
+
+static void finish(void) {
+	printf("frames %llu reports %llu changes %llu hash %016llx\n", frame, reports, changes, hash);
+	if (marks != NULL) {
+		fprintf(marks, "%llu %llu 0\n", frame, reports);
+		fclose(marks);
+	}
+	if (keys != NULL) {
+		fprintf(keys, "%llu %llu %016llx\n", reports, frame, hash);
+		fclose(keys);
+	}
+	if (trace != NULL)
+		fclose(trace);
+	if (checkpoints != NULL)
+		fclose(checkpoints);
+	if (eepromOut != NULL)
+		writeHex(eepromOut, eeprom, sizeof(eeprom));
+}
+
+// Let one USB frame go by.
+void sleep_mode(void) {
+	frame++;
+	if (frame == cutAt) {
+		printf("power cut\n");
+		finish();
+		exit(0);
+	}
+	if (frame > frameLimit) {
+		fprintf(stderr, "ERROR: still running after %llu frames\n", frameLimit);
+		finish();
+		exit(1);
+	}
+
+	if (busEvent && frame == busAt) {
+		if (busEvent == 's') {
+			EVENT_USB_Device_Suspend();
+			USB_DeviceState = DEVICE_STATE_Suspended;
+		} else {
+			EVENT_USB_Device_Reset();
+			USB_DeviceState = DEVICE_STATE_Default;
+		}
+	} else if (busEvent && frame == busAt + busLength) {
+		USB_DeviceState = DEVICE_STATE_Configured;
+		if (busEvent == 's')
+			EVENT_USB_Device_WakeUp();
+		else
+			EVENT_USB_Device_ConfigurationChanged();
+	}
+	// A suspended bus has no frames.
+	if (USB_DeviceState == DEVICE_STATE_Suspended)
+		return;
+
+	inReady = frame % hostPoll == 0;
+	if (sofEnabled)
+		EVENT_USB_Device_StartOfFrame();
+}
+
+static void usage(void) {
+	printf("To run the firmware against an emulated host: Joystick [options]\n");
+	printf("  -e file       EEPROM image to boot with, as written by eepconfig.py\n");
+	printf("  -w file       write the EEPROM image at the end\n");
+	printf("  -o file       write every report to a trace, one per line:\n");
+	printf("                frame buttons hat lx ly rx ry\n");
+	printf("  -d            only trace reports that differ from the last\n");
+	printf("  -k file       write the running hash every 65536 reports, and at the end:\n");
+	printf("                reports frame hash\n");
+	printf("  -c file       write every checkpoint saved, one per line:\n");
+	printf("                frame phase count box col\n");
+	printf("  -m file       write every phase marker as played, one per line:\n");
+	printf("                frame reports mark, ending with a 0 mark\n");
+	printf("  -p ms         poll interval (default 8)\n");
+	printf("  -t from:until send OUT reports every 16ms between these frames\n");
+	printf("  -s at:length  suspend the bus for length frames\n");
+	printf("  -r at:length  reset the bus and configure again after length frames\n");
+	printf("  -x at         cut the power at this frame\n");
+	printf("  -l frames     give up after this many frames (default 100000000)\n");
+}
+
+int main(int argc, char** argv) {
+	int opt;
+	memset(eeprom, 0xFF, sizeof(eeprom));
+
+	while ((opt = getopt(argc, argv, "he:w:o:dk:c:m:p:t:s:r:x:l:")) != -1) {
+		switch (opt) {
+			case 'e':
+				if (!readHex(optarg, eeprom, sizeof(eeprom))) {
+					fprintf(stderr, "ERROR: Can't read %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'w':
+				eepromOut = optarg;
+				break;
+			case 'o':
+				trace = fopen(optarg, "w");
+				if (trace == NULL) {
+					fprintf(stderr, "ERROR: Can't write %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'd':
+				changesOnly = true;
+				break;
+			case 'k':
+				keys = fopen(optarg, "w");
+				if (keys == NULL) {
+					fprintf(stderr, "ERROR: Can't write %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'c':
+				checkpoints = fopen(optarg, "w");
+				if (checkpoints == NULL) {
+					fprintf(stderr, "ERROR: Can't write %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'm':
+				marks = fopen(optarg, "w");
+				if (marks == NULL) {
+					fprintf(stderr, "ERROR: Can't write %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'p':
+				hostPoll = strtoul(optarg, NULL, 0);
+				if (hostPoll == 0)
+					hostPoll = 1;
+				break;
+			case 't':
+				sscanf(optarg, "%llu:%llu", &outFrom, &outUntil);
+				break;
+			case 's':
+			case 'r':
+				busEvent = opt;
+				sscanf(optarg, "%llu:%llu", &busAt, &busLength);
+				break;
+			case 'x':
+				cutAt = strtoull(optarg, NULL, 0);
+				break;
+			case 'l':
+				frameLimit = strtoull(optarg, NULL, 0);
+				break;
+			default:
+				usage();
+				return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	FirmwareMain();
+	finish();
+	return 0;
+}
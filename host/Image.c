@@ -0,0 +1,1018 @@
+/*
+Runs a prebuilt image against the emulated host.
+
+Host.c runs the firmware source; this runs the AVR code of an image, such as
+those under HexFiles/, on a small ATmega16U2 core with just enough of the USB
+controller for LUFA: the host resets the bus, addresses and configures the
+device, then takes the IN bank at the poll interval. Every report taken is
+hashed and traced as by Host.c, so an image's timeline can be kept as a
+golden and set against the source's.
+
+Time is the CPU's, at 16MHz. No timers are modelled, as the images use none:
+nothing but the host changes what the firmware sees, and the host only acts
+on frame boundaries. So two shortcuts don't change a single report. A
+firmware that spins on a busy IN bank, sleeps, or comes back round a loop with
+the same registers and nothing stored since would do the same until the next
+frame, and skips ahead to it; a whole job still runs in seconds. The job ends
+when the image stops with interrupts off, as avr-libc does once main()
+returns, or when it settles: the whole machine comes round to the same state
+a poll later, or a turn of the frame number later once it has read it. It can
+only go round the same way from then on, as an image whose main loop idles
+once the job is done does. One that collects or hatches until unplugged is
+stopped with -f.
+
+simavr isn't used for this. Its USB controller is only reached through the
+vhci-hcd kernel module, so a run needs root, and polls come from the Linux
+host when it gets to them. Here the polls come on the same emulated frames
+as Host.c's, so an image and the source can be set against each other
+report for report, and the same run always gives the same stream.
+
+	make Image && ./Image ../HexFiles/Releasing/Joystick.hex
+*/
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLASH_SIZE  0x4000
+#define DATA_SIZE   0x300
+#define RAMEND      (DATA_SIZE - 1)
+#define F_CPU       16000000ULL
+#define FRAME_CYCLES (F_CPU / 1000)
+
+// Registers, as data addresses.
+#define REG_SPL     0x5D
+#define REG_SPH     0x5E
+#define REG_SREG    0x5F
+#define REG_PLLCSR  0x49
+#define REG_USBCON  0xD8
+#define REG_UDCON   0xE0
+#define REG_UDINT   0xE1
+#define REG_UDIEN   0xE2
+#define REG_UDFNUML 0xE4
+#define REG_UDFNUMH 0xE5
+#define REG_UEINTX  0xE8
+#define REG_UENUM   0xE9
+#define REG_UERST   0xEA
+#define REG_UECONX  0xEB
+#define REG_UECFG0X 0xEC
+#define REG_UECFG1X 0xED
+#define REG_UESTA0X 0xEE
+#define REG_UESTA1X 0xEF
+#define REG_UEIENX  0xF0
+#define REG_UEDATX  0xF1
+#define REG_UEBCLX  0xF2
+#define REG_UEINT   0xF4
+
+// SREG
+#define SREG_C 0
+#define SREG_Z 1
+#define SREG_N 2
+#define SREG_V 3
+#define SREG_S 4
+#define SREG_H 5
+#define SREG_T 6
+#define SREG_I 7
+
+// UDINT and UDIEN
+#define EORSTI 3
+// UEINTX
+#define TXINI   0
+#define RXOUTI  2
+#define RXSTPI  3
+#define RWAL    5
+#define FIFOCON 7
+// UECONX, UECFG0X, UECFG1X, UESTA0X
+#define EPEN    0
+#define EPDIR   0
+#define ALLOC   1
+#define CFGOK   7
+#define USBE    7
+#define FRZCLK  5
+#define DETACH  0
+#define PLLE    1
+#define PLOCK   0
+
+// Interrupt vectors, in words.
+#define VECTOR_USB_GEN 0x16
+#define VECTOR_USB_COM 0x18
+
+// Five on the ATmega16U2; UENUM can name eight.
+#define NUM_ENDPOINTS 8
+#define BANK_SIZE     64
+// Bytes of a report, as Host.c.
+#define REPORT_SIZE   8
+
+typedef struct {
+	uint8_t cfg0, cfg1, con, ien;
+	uint8_t flags;             // UEINTX, but for RWAL
+	uint8_t bank[BANK_SIZE];
+	uint8_t length, read;
+	bool busy;                 // IN bank handed to the host
+} endpoint;
+
+// CPU
+static uint16_t flash[FLASH_SIZE / 2];
+static uint8_t data[DATA_SIZE];
+static uint16_t pc = 0;
+static unsigned long long cycles = 0;
+static bool halted = false;
+// Bumped by anything that could make a loop go differently next time round:
+// a store that changes something, a write to the controller, an interrupt or
+// a new frame.
+static unsigned long long progress = 0;
+
+// A loop as last seen going back to its start.
+#define NUM_LOOPS 16
+typedef struct {
+	uint16_t pc;
+	unsigned long long progress;
+	uint8_t registers[32];
+	uint8_t sp[2], sreg;
+} loop;
+static loop loops[NUM_LOOPS];
+
+// The machine as the host last polled it, to tell when it has settled. The
+// frame number is the one input that isn't the same from one poll to the
+// next, so once the firmware has read it the machine is only set against
+// itself a whole turn of the 11 bit frame number earlier.
+#define FRAME_NUMBERS 2048
+static bool frameNumberRead = false;
+static struct {
+	uint8_t data[DATA_SIZE];
+	endpoint endpoints[NUM_ENDPOINTS];
+	unsigned long long frame;
+	uint16_t pc;
+	unsigned long long cycle;
+	uint8_t udint;
+} polled;
+
+// USB controller
+static endpoint endpoints[NUM_ENDPOINTS];
+static uint8_t udint = 0;
+
+// Emulated host.
+static unsigned long long frame = 0;
+static unsigned long long frameLimit = 100000000ULL;
+// Where to stop an image that runs until unplugged, if not 0.
+static unsigned long long stopAt = 0;
+static unsigned hostPoll = 8;
+// Bus reset, then SET_ADDRESS and SET_CONFIGURATION, one step a frame.
+static uint8_t enumeration = 0;
+static const uint8_t setAddress[8] = {0x00, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
+static const uint8_t setConfiguration[8] = {0x00, 0x09, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// Report stream.
+static uint8_t lastReport[REPORT_SIZE];
+static unsigned long long reports = 0, changes = 0;
+static unsigned long long hash = 14695981039346656037ULL;
+static FILE* trace = NULL;
+static FILE* keys = NULL;
+static unsigned long keyInterval = 65536;
+static bool changesOnly = false;
+
+static void fail(const char* what) {
+	fprintf(stderr, "ERROR: %s at %04x, frame %llu\n", what, pc * 2, frame);
+	exit(1);
+}
+
+// Read the data records of an Intel HEX file into flash.
+static bool readHex(const char* path) {
+	FILE* f = fopen(path, "r");
+	uint8_t* image = (uint8_t*)flash;
+	char line[600];
+	if (f == NULL)
+		return false;
+	memset(flash, 0xFF, sizeof(flash));
+	while (fgets(line, sizeof(line), f)) {
+		unsigned count, address, type, byte, i;
+		if (sscanf(line, ":%2x%4x%2x", &count, &address, &type) != 3)
+			continue;
+		if (type != 0)
+			continue;
+		for (i = 0; i < count && address + i < FLASH_SIZE; i++) {
+			sscanf(line + 9 + i * 2, "%2x", &byte);
+			image[address + i] = byte;
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+// USB controller
+
+static endpoint* selected(void) {
+	return &endpoints[data[REG_UENUM] & 0x07];
+}
+
+static bool isIN(const endpoint* ep) {
+	return (ep->cfg0 >> 6) != 0 && (ep->cfg0 & (1 << EPDIR));
+}
+
+static bool isControl(const endpoint* ep) {
+	return (ep->cfg0 >> 6) == 0;
+}
+
+static bool enabled(const endpoint* ep) {
+	return (ep->con & (1 << EPEN)) && (ep->cfg1 & (1 << ALLOC));
+}
+
+static uint8_t readUEINTX(const endpoint* ep) {
+	bool rwal;
+	if (isControl(ep))
+		rwal = true;
+	else if (isIN(ep))
+		rwal = !ep->busy && ep->length < BANK_SIZE;
+	else
+		rwal = ep->read < ep->length;
+	return ep->flags | (rwal ? 1 << RWAL : 0);
+}
+
+// The host has taken the report in the IN bank.
+static void takeReport(endpoint* ep) {
+	uint8_t report[REPORT_SIZE];
+	bool changed;
+	uint8_t i;
+
+	memset(report, 0, sizeof(report));
+	memcpy(report, ep->bank, ep->length < REPORT_SIZE ? ep->length : REPORT_SIZE);
+	changed = memcmp(report, lastReport, sizeof(report)) != 0;
+	reports++;
+	if (changed)
+		changes++;
+	for (i = 0; i < 8; i++)
+		hash = (hash ^ ((frame >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+	for (i = 0; i < REPORT_SIZE; i++)
+		hash = (hash ^ report[i]) * 1099511628211ULL;
+
+	if (trace != NULL && (changed || !changesOnly))
+		fprintf(trace, "%llu %04x %x %u %u %u %u\n", frame,
+			report[0] | report[1] << 8, report[2], report[3], report[4], report[5], report[6]);
+	if (keys != NULL && reports % keyInterval == 0)
+		fprintf(keys, "%llu %llu %016llx\n", reports, frame, hash);
+	memcpy(lastReport, report, sizeof(report));
+
+	ep->busy = false;
+	ep->length = 0;
+	ep->flags |= (1 << TXINI) | (1 << FIFOCON);
+}
+
+static void setup(const uint8_t* request) {
+	endpoint* ep = &endpoints[0];
+	memcpy(ep->bank, request, 8);
+	ep->length = 8;
+	ep->read = 0;
+	ep->flags |= 1 << RXSTPI;
+}
+
+static bool attached(void) {
+	return (data[REG_USBCON] & (1 << USBE)) && !(data[REG_USBCON] & (1 << FRZCLK))
+		&& !(data[REG_UDCON] & (1 << DETACH));
+}
+
+// Whether the machine is as it was at the last poll it was set against. If it
+// is, everything it can see is the same too, so it will go round the same way
+// for good.
+static bool settled(void) {
+	bool same;
+	if (frameNumberRead && frame % FRAME_NUMBERS != 0)
+		return false;
+	same = (!frameNumberRead || (frame - polled.frame) % FRAME_NUMBERS == 0)
+		&& polled.pc == pc && polled.cycle == cycles - frame * FRAME_CYCLES
+		&& polled.udint == udint && memcmp(polled.data, data, sizeof(data)) == 0
+		&& memcmp(polled.endpoints, endpoints, sizeof(endpoints)) == 0;
+	memcpy(polled.data, data, sizeof(data));
+	memcpy(polled.endpoints, endpoints, sizeof(endpoints));
+	polled.frame = frame;
+	polled.pc = pc;
+	polled.cycle = cycles - frame * FRAME_CYCLES;
+	polled.udint = udint;
+	return same;
+}
+
+// Let one USB frame go by.
+static void nextFrame(void) {
+	uint8_t i;
+	frame++;
+	progress++;
+	if (frame > frameLimit) {
+		fprintf(stderr, "ERROR: still running after %llu frames\n", frameLimit);
+		exit(1);
+	}
+	if (!attached())
+		return;
+
+	udint |= 1 << 2;  // SOFI
+	if (enumeration == 0) {
+		udint |= 1 << EORSTI;
+		enumeration++;
+	} else if (enumeration == 1 && !(udint & (1 << EORSTI)) && enabled(&endpoints[0])) {
+		setup(setAddress);
+		enumeration++;
+	} else if (enumeration == 2 && !(endpoints[0].flags & (1 << RXSTPI))) {
+		setup(setConfiguration);
+		enumeration++;
+	}
+
+	if (frame % hostPoll == 0) {
+		for (i = 1; i < NUM_ENDPOINTS; i++) {
+			endpoint* ep = &endpoints[i];
+			if (enabled(ep) && isIN(ep) && ep->busy)
+				takeReport(ep);
+		}
+		if (enumeration == 3 && settled())
+			halted = true;
+	}
+	if (frame == stopAt)
+		halted = true;
+}
+
+// Run the frames up to the next poll, for a firmware that can't do anything
+// until then.
+static void skipToPoll(void) {
+	unsigned long long target = (frame / hostPoll + 1) * hostPoll;
+	while (frame < target && !halted)
+		nextFrame();
+	cycles = frame * FRAME_CYCLES;
+}
+
+static uint8_t readIO(uint16_t address) {
+	endpoint* ep = selected();
+	switch (address) {
+		case REG_PLLCSR:
+			return data[address] & (1 << PLLE) ? data[address] | (1 << PLOCK) : data[address];
+		case REG_UDINT:
+			return udint;
+		case REG_UDFNUML:
+			frameNumberRead = true;
+			return frame & 0xFF;
+		case REG_UDFNUMH:
+			frameNumberRead = true;
+			return (frame >> 8) & 0x07;
+		case REG_UEINTX:
+			if (enabled(ep) && isIN(ep) && ep->busy)
+				skipToPoll();
+			return readUEINTX(ep);
+		case REG_UECONX:
+			return ep->con;
+		case REG_UECFG0X:
+			return ep->cfg0;
+		case REG_UECFG1X:
+			return ep->cfg1;
+		case REG_UESTA0X:
+			return ep->cfg1 & (1 << ALLOC) ? 1 << CFGOK : 0;
+		case REG_UESTA1X:
+			return 0;
+		case REG_UEIENX:
+			return ep->ien;
+		case REG_UEDATX:
+			return ep->read < ep->length ? ep->bank[ep->read++] : 0;
+		case REG_UEBCLX:
+			return isIN(ep) ? ep->length : ep->length - ep->read;
+		case REG_UEINT: {
+			uint8_t i, v = 0;
+			for (i = 0; i < NUM_ENDPOINTS; i++)
+				if (endpoints[i].flags & endpoints[i].ien)
+					v |= 1 << i;
+			return v;
+		}
+	}
+	return data[address];
+}
+
+static void writeIO(uint16_t address, uint8_t value) {
+	endpoint* ep = selected();
+	if (address >= REG_USBCON || data[address] != value)
+		progress++;
+	switch (address) {
+		case REG_UDINT:
+			// Flags are cleared by writing 0.
+			udint &= value;
+			return;
+		case REG_UEINTX: {
+			uint8_t was = ep->flags;
+			ep->flags &= value | (1 << RWAL);
+			ep->flags &= ~(1 << RWAL);
+			if (isControl(ep)) {
+				if ((was & (1 << RXSTPI)) && !(ep->flags & (1 << RXSTPI)))
+					ep->length = ep->read = 0;
+				// The host takes IN data, or the status stage, at once.
+				if ((was & (1 << TXINI)) && !(ep->flags & (1 << TXINI))) {
+					ep->length = 0;
+					ep->flags |= 1 << TXINI;
+				}
+			} else if (isIN(ep)) {
+				if ((was & (1 << FIFOCON)) && !(ep->flags & (1 << FIFOCON)))
+					ep->busy = true;
+			} else if ((was & (1 << FIFOCON)) && !(ep->flags & (1 << FIFOCON))) {
+				ep->length = ep->read = 0;
+			}
+			return;
+		}
+		case REG_UECONX:
+			ep->con = value & ~((1 << 3) | (1 << 4));
+			return;
+		case REG_UECFG0X:
+			ep->cfg0 = value;
+			return;
+		case REG_UECFG1X:
+			ep->cfg1 = value;
+			if (value & (1 << ALLOC)) {
+				ep->length = ep->read = 0;
+				ep->busy = false;
+				ep->flags = isControl(ep) || isIN(ep) ? (1 << TXINI) | (1 << FIFOCON) : 0;
+			}
+			return;
+		case REG_UEIENX:
+			ep->ien = value;
+			return;
+		case REG_UEDATX:
+			if (ep->length < BANK_SIZE)
+				ep->bank[ep->length++] = value;
+			return;
+		case REG_UDFNUML:
+		case REG_UDFNUMH:
+		case REG_UESTA0X:
+		case REG_UEBCLX:
+		case REG_UEINT:
+			return;
+	}
+	data[address] = value;
+}
+
+// CPU
+
+static inline uint8_t load(uint16_t address) {
+	if (address < 0x20)
+		return data[address];
+	if (address >= 0x40 && address < 0x100 && address != REG_SPL && address != REG_SPH
+			&& address != REG_SREG)
+		return readIO(address);
+	if (address >= DATA_SIZE)
+		fail("read outside SRAM");
+	return data[address];
+}
+
+static inline void store(uint16_t address, uint8_t value) {
+	if (address >= 0x40 && address < 0x100 && address != REG_SPL && address != REG_SPH
+			&& address != REG_SREG) {
+		writeIO(address, value);
+		return;
+	}
+	if (address >= DATA_SIZE)
+		fail("write outside SRAM");
+	if (data[address] != value)
+		progress++;
+	data[address] = value;
+}
+
+static inline uint16_t sp(void) {
+	return data[REG_SPL] | data[REG_SPH] << 8;
+}
+
+static inline void setSP(uint16_t value) {
+	data[REG_SPL] = value & 0xFF;
+	data[REG_SPH] = value >> 8;
+}
+
+static inline void push(uint8_t value) {
+	uint16_t s = sp();
+	store(s, value);
+	setSP(s - 1);
+}
+
+static inline uint8_t pop(void) {
+	uint16_t s = sp() + 1;
+	setSP(s);
+	return load(s);
+}
+
+static inline void pushPC(uint16_t address) {
+	push(address & 0xFF);
+	push(address >> 8);
+}
+
+static inline uint16_t popPC(void) {
+	uint16_t high = pop();
+	return high << 8 | pop();
+}
+
+#define FLAG(b)       ((data[REG_SREG] >> (b)) & 1)
+#define SET_FLAG(b, v) (data[REG_SREG] = (data[REG_SREG] & ~(1 << (b))) | ((v) ? 1 << (b) : 0))
+#define R             data
+#define WORD(r)       (R[r] | R[(r) + 1] << 8)
+
+static inline void setNZS(uint8_t result) {
+	SET_FLAG(SREG_N, result >> 7);
+	SET_FLAG(SREG_Z, result == 0);
+	SET_FLAG(SREG_S, FLAG(SREG_N) ^ FLAG(SREG_V));
+}
+
+static inline uint8_t add(uint8_t d, uint8_t r, uint8_t carry) {
+	uint8_t result = d + r + carry;
+	SET_FLAG(SREG_H, ((d & r) | (r & ~result) | (~result & d)) & 0x08);
+	SET_FLAG(SREG_C, ((d & r) | (r & ~result) | (~result & d)) & 0x80);
+	SET_FLAG(SREG_V, ((d & r & ~result) | (~d & ~r & result)) & 0x80);
+	setNZS(result);
+	return result;
+}
+
+// Subtract, as SUB and CP, or with carry and keeping Z as SBC and CPC.
+static inline uint8_t sub(uint8_t d, uint8_t r, uint8_t carry, bool keepZ) {
+	uint8_t result = d - r - carry;
+	bool z = FLAG(SREG_Z);
+	SET_FLAG(SREG_H, ((~d & r) | (r & result) | (result & ~d)) & 0x08);
+	SET_FLAG(SREG_C, ((~d & r) | (r & result) | (result & ~d)) & 0x80);
+	SET_FLAG(SREG_V, ((d & ~r & ~result) | (~d & r & result)) & 0x80);
+	setNZS(result);
+	if (keepZ)
+		SET_FLAG(SREG_Z, result == 0 && z);
+	return result;
+}
+
+static inline void logic(uint8_t result) {
+	SET_FLAG(SREG_V, 0);
+	setNZS(result);
+}
+
+// Length in words of the instruction at address, for skips.
+static inline int length(uint16_t address) {
+	uint16_t op = flash[address];
+	if ((op & 0xFC0F) == 0x9000 || (op & 0xFE0C) == 0x940C)  // LDS, STS, JMP, CALL
+		return 2;
+	return 1;
+}
+
+static void interrupt(uint16_t vector) {
+	SET_FLAG(SREG_I, 0);
+	pushPC(pc);
+	pc = vector;
+	cycles += 5;
+	progress++;
+}
+
+// Going back to target. A loop that comes round to the same registers with
+// no progress made will only do the same again until the next frame.
+static void loopTo(uint16_t target) {
+	loop* l = &loops[target % NUM_LOOPS];
+	if (l->pc == target && l->progress == progress && l->sreg == data[REG_SREG]
+			&& l->sp[0] == data[REG_SPL] && l->sp[1] == data[REG_SPH]
+			&& memcmp(l->registers, data, sizeof(l->registers)) == 0) {
+		cycles = (frame + 1) * FRAME_CYCLES;
+		return;
+	}
+	l->pc = target;
+	l->progress = progress;
+	l->sreg = data[REG_SREG];
+	l->sp[0] = data[REG_SPL];
+	l->sp[1] = data[REG_SPH];
+	memcpy(l->registers, data, sizeof(l->registers));
+}
+
+static void step(void) {
+	uint16_t op = flash[pc];
+	uint8_t d = (op >> 4) & 0x1F;
+	uint8_t r = (op & 0x0F) | ((op >> 5) & 0x10);
+	uint8_t k = (op & 0x0F) | ((op >> 4) & 0xF0);
+	uint8_t dh = 16 + ((op >> 4) & 0x0F);
+	pc++;
+	cycles++;
+
+	switch (op >> 12) {
+		case 0x0:
+			if (op == 0x0000) {
+				// NOP
+			} else if ((op & 0xFF00) == 0x0100) {  // MOVW
+				R[((op >> 4) & 0x0F) * 2] = R[(op & 0x0F) * 2];
+				R[((op >> 4) & 0x0F) * 2 + 1] = R[(op & 0x0F) * 2 + 1];
+			} else if ((op & 0xFF00) == 0x0200) {  // MULS
+				int16_t result = (int8_t)R[dh] * (int8_t)R[16 + (op & 0x0F)];
+				R[0] = result & 0xFF;
+				R[1] = (uint16_t)result >> 8;
+				SET_FLAG(SREG_C, (uint16_t)result >> 15);
+				SET_FLAG(SREG_Z, result == 0);
+				cycles++;
+			} else if ((op & 0xFF88) == 0x0300) {  // MULSU
+				int16_t result = (int8_t)R[16 + ((op >> 4) & 7)] * (uint8_t)R[16 + (op & 7)];
+				R[0] = result & 0xFF;
+				R[1] = (uint16_t)result >> 8;
+				SET_FLAG(SREG_C, (uint16_t)result >> 15);
+				SET_FLAG(SREG_Z, result == 0);
+				cycles++;
+			} else if ((op & 0xFF00) == 0x0300) {
+				fail("FMUL");
+			} else {
+				switch (op & 0xFC00) {
+					case 0x0400:  // CPC
+						sub(R[d], R[r], FLAG(SREG_C), true);
+						break;
+					case 0x0800:  // SBC
+						R[d] = sub(R[d], R[r], FLAG(SREG_C), true);
+						break;
+					case 0x0C00:  // ADD
+						R[d] = add(R[d], R[r], 0);
+						break;
+				}
+			}
+			break;
+		case 0x1:
+			switch (op & 0xFC00) {
+				case 0x1000:  // CPSE
+					if (R[d] == R[r]) {
+						cycles += length(pc);
+						pc += length(pc);
+					}
+					break;
+				case 0x1400:  // CP
+					sub(R[d], R[r], 0, false);
+					break;
+				case 0x1800:  // SUB
+					R[d] = sub(R[d], R[r], 0, false);
+					break;
+				case 0x1C00:  // ADC
+					R[d] = add(R[d], R[r], FLAG(SREG_C));
+					break;
+			}
+			break;
+		case 0x2:
+			switch (op & 0xFC00) {
+				case 0x2000:  // AND
+					R[d] &= R[r];
+					logic(R[d]);
+					break;
+				case 0x2400:  // EOR
+					R[d] ^= R[r];
+					logic(R[d]);
+					break;
+				case 0x2800:  // OR
+					R[d] |= R[r];
+					logic(R[d]);
+					break;
+				case 0x2C00:  // MOV
+					R[d] = R[r];
+					break;
+			}
+			break;
+		case 0x3:  // CPI
+			sub(R[dh], k, 0, false);
+			break;
+		case 0x4:  // SBCI
+			R[dh] = sub(R[dh], k, FLAG(SREG_C), true);
+			break;
+		case 0x5:  // SUBI
+			R[dh] = sub(R[dh], k, 0, false);
+			break;
+		case 0x6:  // ORI
+			R[dh] |= k;
+			logic(R[dh]);
+			break;
+		case 0x7:  // ANDI
+			R[dh] &= k;
+			logic(R[dh]);
+			break;
+		case 0x8:
+		case 0xA: {  // LDD, STD
+			uint8_t q = (op & 0x07) | ((op >> 7) & 0x18) | ((op >> 8) & 0x20);
+			uint16_t base = op & 0x0008 ? WORD(28) : WORD(30);
+			if (op & 0x0200)
+				store(base + q, R[d]);
+			else
+				R[d] = load(base + q);
+			cycles++;
+			break;
+		}
+		case 0x9:
+			if ((op & 0xFC00) == 0x9000) {
+				bool st = op & 0x0200;
+				uint16_t x;
+				cycles++;
+				switch (op & 0x000F) {
+					case 0x0:  // LDS, STS
+						x = flash[pc++];
+						if (st)
+							store(x, R[d]);
+						else
+							R[d] = load(x);
+						break;
+					case 0x1: case 0x2:  // Z+, -Z
+					case 0x9: case 0xA:  // Y+, -Y
+					case 0xC: case 0xD: case 0xE: {  // X, X+, -X
+						uint8_t p = (op & 0x0F) >= 0xC ? 26 : (op & 0x0F) >= 0x9 ? 28 : 30;
+						uint16_t a = WORD(p);
+						if ((op & 0x03) == 0x2)
+							a--;
+						if (st)
+							store(a, R[d]);
+						else
+							R[d] = load(a);
+						if ((op & 0x03) == 0x1)
+							a++;
+						R[p] = a & 0xFF;
+						R[p + 1] = a >> 8;
+						break;
+					}
+					case 0x4: case 0x5: case 0x6: case 0x7:  // LPM, ELPM Z(+)
+						if (st)
+							fail("XCH/LAS/LAC/LAT");
+						x = WORD(30);
+						R[d] = ((uint8_t*)flash)[x % FLASH_SIZE];
+						if (op & 0x01) {
+							x++;
+							R[30] = x & 0xFF;
+							R[31] = x >> 8;
+						}
+						cycles++;
+						break;
+					case 0xF:  // PUSH, POP
+						if (st)
+							push(R[d]);
+						else
+							R[d] = pop();
+						break;
+					default:
+						fail("unknown load or store");
+				}
+			} else if ((op & 0xFE08) == 0x9400) {
+				uint8_t v = R[d];
+				switch (op & 0x0007) {
+					case 0x0:  // COM
+						R[d] = ~v;
+						logic(R[d]);
+						SET_FLAG(SREG_C, 1);
+						break;
+					case 0x1:  // NEG
+						R[d] = sub(0, v, 0, false);
+						break;
+					case 0x2:  // SWAP
+						R[d] = (v << 4) | (v >> 4);
+						break;
+					case 0x3:  // INC
+						R[d] = v + 1;
+						SET_FLAG(SREG_V, R[d] == 0x80);
+						setNZS(R[d]);
+						break;
+					case 0x5:  // ASR
+						R[d] = (v >> 1) | (v & 0x80);
+						SET_FLAG(SREG_C, v & 1);
+						SET_FLAG(SREG_N, R[d] >> 7);
+						SET_FLAG(SREG_V, FLAG(SREG_N) ^ FLAG(SREG_C));
+						setNZS(R[d]);
+						break;
+					case 0x6:  // LSR
+						R[d] = v >> 1;
+						SET_FLAG(SREG_C, v & 1);
+						SET_FLAG(SREG_V, FLAG(SREG_C));
+						setNZS(R[d]);
+						break;
+					case 0x7:  // ROR
+						R[d] = (v >> 1) | (FLAG(SREG_C) << 7);
+						SET_FLAG(SREG_C, v & 1);
+						SET_FLAG(SREG_N, R[d] >> 7);
+						SET_FLAG(SREG_V, FLAG(SREG_N) ^ FLAG(SREG_C));
+						setNZS(R[d]);
+						break;
+					default:
+						fail("unknown one-operand instruction");
+				}
+			} else if ((op & 0xFE0F) == 0x940A) {  // DEC
+				R[d]--;
+				SET_FLAG(SREG_V, R[d] == 0x7F);
+				setNZS(R[d]);
+			} else if ((op & 0xFE0C) == 0x940C) {  // JMP, CALL
+				uint16_t target = flash[pc++];
+				if (op & 0x0002) {
+					pushPC(pc);
+					cycles += 3;
+				} else {
+					cycles += 2;
+					if (target < pc)
+						loopTo(target);
+				}
+				pc = target;
+			} else if ((op & 0xFF0F) == 0x9408) {  // BSET, BCLR
+				SET_FLAG((op >> 4) & 7, !(op & 0x0080));
+			} else if (op == 0x9508 || op == 0x9518) {  // RET, RETI
+				pc = popPC();
+				if (op == 0x9518)
+					SET_FLAG(SREG_I, 1);
+				cycles += 3;
+			} else if (op == 0x9588) {  // SLEEP
+				if (!FLAG(SREG_I)) {
+					halted = true;
+					return;
+				}
+				// Nothing wakes the firmware before the next frame.
+				cycles = (frame + 1) * FRAME_CYCLES;
+			} else if (op == 0x95A8 || op == 0x9598) {  // WDR, BREAK
+			} else if (op == 0x95C8) {  // LPM r0
+				R[0] = ((uint8_t*)flash)[WORD(30) % FLASH_SIZE];
+				cycles += 2;
+			} else if (op == 0x9409) {  // IJMP
+				pc = WORD(30);
+				cycles++;
+			} else if (op == 0x9509) {  // ICALL
+				pushPC(pc);
+				pc = WORD(30);
+				cycles += 2;
+			} else if ((op & 0xFE00) == 0x9600) {  // ADIW, SBIW
+				uint8_t p = 24 + ((op >> 3) & 0x06);
+				uint8_t kk = (op & 0x0F) | ((op >> 2) & 0x30);
+				uint16_t v = WORD(p);
+				uint16_t result = op & 0x0100 ? v - kk : v + kk;
+				if (op & 0x0100) {
+					SET_FLAG(SREG_V, (v & ~result) & 0x8000);
+					SET_FLAG(SREG_C, (result & ~v) & 0x8000);
+				} else {
+					SET_FLAG(SREG_V, (~v & result) & 0x8000);
+					SET_FLAG(SREG_C, (~result & v) & 0x8000);
+				}
+				SET_FLAG(SREG_N, result >> 15);
+				SET_FLAG(SREG_Z, result == 0);
+				SET_FLAG(SREG_S, FLAG(SREG_N) ^ FLAG(SREG_V));
+				R[p] = result & 0xFF;
+				R[p + 1] = result >> 8;
+				cycles++;
+			} else if ((op & 0xFC00) == 0x9800) {  // CBI, SBIC, SBI, SBIS
+				uint16_t a = 0x20 + ((op >> 3) & 0x1F);
+				uint8_t bit = 1 << (op & 7);
+				switch (op & 0x0300) {
+					case 0x0000:
+						store(a, load(a) & ~bit);
+						cycles++;
+						break;
+					case 0x0200:
+						store(a, load(a) | bit);
+						cycles++;
+						break;
+					default:
+						// SBIC skips on a clear bit, SBIS on a set one.
+						if (!!(load(a) & bit) == ((op & 0x0300) == 0x0300)) {
+							cycles += length(pc);
+							pc += length(pc);
+						}
+				}
+			} else if ((op & 0xFC00) == 0x9C00) {  // MUL
+				uint16_t result = R[d] * R[r];
+				R[0] = result & 0xFF;
+				R[1] = result >> 8;
+				SET_FLAG(SREG_C, result >> 15);
+				SET_FLAG(SREG_Z, result == 0);
+				cycles++;
+			} else {
+				fail("unknown instruction");
+			}
+			break;
+		case 0xB: {  // IN, OUT
+			uint16_t a = 0x20 + ((op & 0x0F) | ((op >> 5) & 0x30));
+			if (op & 0x0800)
+				store(a, R[d]);
+			else
+				R[d] = load(a);
+			break;
+		}
+		case 0xC:  // RJMP
+		case 0xD: {  // RCALL
+			int16_t offset = (int16_t)(op << 4) >> 4;
+			if (op & 0x1000) {
+				pushPC(pc);
+				cycles += 2;
+			} else if (offset == -1 && !FLAG(SREG_I)) {
+				// Stopped for good, as after main() returns.
+				halted = true;
+				return;
+			}
+			pc += offset;
+			cycles++;
+			if (offset < 0 && !(op & 0x1000))
+				loopTo(pc);
+			break;
+		}
+		case 0xE:  // LDI
+			R[dh] = k;
+			break;
+		case 0xF:
+			if (!(op & 0x0800)) {  // BRBS, BRBC
+				bool set = FLAG(op & 7);
+				if (set == !(op & 0x0400)) {
+					int8_t offset = (int8_t)((op >> 2) & 0xFE) >> 1;
+					pc += offset;
+					cycles++;
+					if (offset < 0)
+						loopTo(pc);
+				}
+			} else if ((op & 0x0C08) == 0x0800) {  // BLD, BST
+				if (op & 0x0200)
+					SET_FLAG(SREG_T, (R[d] >> (op & 7)) & 1);
+				else
+					R[d] = (R[d] & ~(1 << (op & 7))) | (FLAG(SREG_T) << (op & 7));
+			} else if ((op & 0x0C08) == 0x0C00) {  // SBRC, SBRS
+				bool set = (R[d] >> (op & 7)) & 1;
+				if (set == !!(op & 0x0200)) {
+					cycles += length(pc);
+					pc += length(pc);
+				}
+			} else {
+				fail("unknown instruction");
+			}
+			break;
+	}
+}
+
+static void run(void) {
+	while (!halted) {
+		uint8_t i;
+		while (cycles >= (frame + 1) * FRAME_CYCLES)
+			nextFrame();
+
+		if (FLAG(SREG_I)) {
+			if (udint & data[REG_UDIEN] & 0x7D) {
+				interrupt(VECTOR_USB_GEN);
+				continue;
+			}
+			for (i = 0; i < NUM_ENDPOINTS; i++) {
+				if (endpoints[i].flags & endpoints[i].ien) {
+					interrupt(VECTOR_USB_COM);
+					break;
+				}
+			}
+			if (i < NUM_ENDPOINTS)
+				continue;
+		}
+		step();
+	}
+}
+
+static void usage(void) {
+	printf("To run a prebuilt image against an emulated host: Image [options] image.hex\n");
+	printf("  -o file       write every report to a trace, one per line:\n");
+	printf("                frame buttons hat lx ly rx ry\n");
+	printf("  -d            only trace reports that differ from the last\n");
+	printf("  -k file       write the running hash every 65536 reports, and at the end:\n");
+	printf("                reports frame hash\n");
+	printf("  -p ms         poll interval (default 8)\n");
+	printf("  -f frames     stop after this many frames, for an image that runs until\n");
+	printf("                unplugged\n");
+	printf("  -l frames     give up after this many frames (default 100000000)\n");
+}
+
+int main(int argc, char** argv) {
+	int opt;
+
+	while ((opt = getopt(argc, argv, "ho:dk:p:f:l:")) != -1) {
+		switch (opt) {
+			case 'o':
+			case 'k': {
+				FILE* f = fopen(optarg, "w");
+				if (f == NULL) {
+					fprintf(stderr, "ERROR: Can't write %s\n", optarg);
+					return 1;
+				}
+				if (opt == 'o')
+					trace = f;
+				else
+					keys = f;
+				break;
+			}
+			case 'd':
+				changesOnly = true;
+				break;
+			case 'p':
+				hostPoll = strtoul(optarg, NULL, 0);
+				if (hostPoll == 0)
+					hostPoll = 1;
+				break;
+			case 'f':
+				stopAt = strtoull(optarg, NULL, 0);
+				break;
+			case 'l':
+				frameLimit = strtoull(optarg, NULL, 0);
+				break;
+			default:
+				usage();
+				return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (optind != argc - 1) {
+		usage();
+		return 1;
+	}
+	if (!readHex(argv[optind])) {
+		fprintf(stderr, "ERROR: Can't read %s\n", argv[optind]);
+		return 1;
+	}
+
+	setSP(RAMEND);
+	run();
+
+	printf("frames %llu reports %llu changes %llu hash %016llx\n", frame, reports, changes, hash);
+	if (keys != NULL)
+		fprintf(keys, "%llu %llu %016llx\n", reports, frame, hash);
+	if (trace != NULL)
+		fclose(trace);
+	if (keys != NULL)
+		fclose(keys);
+	return 0;
+}
@@ -0,0 +1,374 @@
+#!/bin/python
+
+import sys, os, getopt, subprocess, tempfile, bisect, importlib.util
+
+# The job each prebuilt image in HexFiles/ was built for, as make parameters.
+# Each image has two goldens: the timeline of the current source built with
+# the same parameters and run by the host build, and the report stream of the
+# image itself, run by Image on an emulated core.
+IMAGES = [
+  ("Collecting", "MODE=COLLECTING"),
+  ("Hatching/5-cycle", "MODE=HATCHING CYCLES=5"),
+  ("Hatching/10-cycle", "MODE=HATCHING CYCLES=10"),
+  ("Hatching/15-cycle", "MODE=HATCHING CYCLES=15"),
+  ("Hatching/20-cycle", "MODE=HATCHING CYCLES=20"),
+  ("Hatching/25-cycle", "MODE=HATCHING CYCLES=25"),
+  ("Hatching/30-cycle", "MODE=HATCHING CYCLES=30"),
+  ("Hatching/35-cycle", "MODE=HATCHING CYCLES=35"),
+  ("Hatching/40-cycle", "MODE=HATCHING CYCLES=40"),
+  ("FullBreed/35-eggs/20-Cycle", "MODE=COLLECT_THEN_HATCH EGGS=35 CYCLES=20"),
+  ("FullBreed/330-eggs/20-Cycle", "MODE=COLLECT_THEN_HATCH EGGS=330 CYCLES=20"),
+  ("Releasing", "MODE=RELEASING"),
+]
+
+# Jobs of no image that cover cases the images don't: a partial last column
+# released as it hatches.
+JOBS = [
+  ("PartialRelease", "MODE=COLLECT_THEN_HATCH EGGS=33 CYCLES=5 RELEASE_HATCHED=1"),
+]
+
+# CheckpointPhase_t
+PHASES = ["done", "collect", "hatch_start", "hatch", "pipeline", "release"]
+
+# The collecting and hatching images run until unplugged; their report
+# stream is kept up to this frame, longer than any of their jobs takes the
+# source.
+UNPLUG_AT = 25000000
+
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+HEX_DIR = os.path.join(HOST_DIR, "..", "HexFiles")
+GOLDEN_DIR = os.path.join(HOST_DIR, "golden")
+IMAGE_GOLDEN_DIR = os.path.join(GOLDEN_DIR, "images")
+
+def goldenPath(image):
+  return os.path.join(GOLDEN_DIR, image.replace("/", "-") + ".txt")
+
+def imageGoldenPath(image):
+  return os.path.join(IMAGE_GOLDEN_DIR, image.replace("/", "-") + ".txt")
+
+def hexPath(image):
+  return os.path.join(HEX_DIR, image, "Joystick.hex")
+
+def readKeys(path):
+  with open(path) as f:
+    return [tuple(int(v, 16) if i == 2 else int(v) for i, v in enumerate(line.split())) for line in f]
+
+# Build the host firmware for an image's job and run it. Returns the summary
+# line, the checkpoints as (frame, phase, count, box, col) and the running
+# hash every 65536 reports as (reports, frame, hash). If traced, also the paths
+# of its changes-only trace and its phase marks.
+def run(image, params, workDir, traced=False):
+  binary = os.path.join(workDir, image.replace("/", "-"))
+  build = subprocess.run(["make", "-s", "-B", "-C", HOST_DIR, "TARGET=" + binary] + params.split(),
+      stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+  if build.returncode != 0:
+    print(build.stdout.decode())
+    print("ERROR: Can't build {}".format(image))
+    sys.exit(1)
+  log, keys = binary + ".checkpoints", binary + ".keys"
+  trace, marks = binary + ".trace", binary + ".marks"
+  options = ["-d", "-o", trace, "-m", marks] if traced else []
+  out = subprocess.check_output([binary, "-c", log, "-k", keys] + options).decode()
+  summary = out.splitlines()[-1]
+  with open(log) as f:
+    checkpoints = [tuple(int(v) for v in line.split()) for line in f]
+  return summary, checkpoints, readKeys(keys), (trace, marks) if traced else None
+
+# Run a prebuilt image. Returns the summary line and the running hash as run(),
+# and the path of its changes-only trace.
+def runImage(image, workDir):
+  build = subprocess.run(["make", "-s", "-C", HOST_DIR, "Image"],
+      stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+  if build.returncode != 0:
+    print(build.stdout.decode())
+    print("ERROR: Can't build Image")
+    sys.exit(1)
+  keys = os.path.join(workDir, image.replace("/", "-") + ".image.keys")
+  trace = os.path.join(workDir, image.replace("/", "-") + ".image.trace")
+  out = subprocess.check_output([os.path.join(HOST_DIR, "Image"), "-f", str(UNPLUG_AT),
+      "-k", keys, "-d", "-o", trace, hexPath(image)]).decode()
+  return out.splitlines()[-1], readKeys(keys), trace
+
+def writeImage(path, image, summary, keys):
+  with open(path, "w") as f:
+    f.write("# HexFiles/{}/Joystick.hex: Image -f {}\n".format(image, UNPLUG_AT))
+    f.write(summary + "\n")
+    for key in keys:
+      f.write("{} {} {:016x}\n".format(*key))
+
+def readImage(path):
+  with open(path) as f:
+    lines = [line.strip() for line in f if not line.startswith("#")]
+  keys = [tuple(int(v, 16) if i == 2 else int(v) for i, v in enumerate(line.split()))
+      for line in lines[1:]]
+  return lines[0], keys
+
+def write(path, image, params, summary, checkpoints):
+  with open(path, "w") as f:
+    f.write("# {}: make {}\n".format("HexFiles/" + image if image in dict(IMAGES) else image, params))
+    f.write(summary + "\n")
+    for cp in checkpoints:
+      f.write("{} {} {} {} {}\n".format(cp[0], PHASES[cp[1]], cp[2], cp[3], cp[4]))
+
+def read(path):
+  with open(path) as f:
+    lines = [line.strip() for line in f if not line.startswith("#")]
+  checkpoints = []
+  for line in lines[1:]:
+    fields = line.split()
+    checkpoints.append((int(fields[0]), PHASES.index(fields[1])) + tuple(int(v) for v in fields[2:]))
+  return lines[0], checkpoints
+
+def field(summary, name):
+  fields = summary.split()
+  return fields[fields.index(name) + 1]
+
+# Frames spent in each phase. A stretch of the job belongs to the checkpoint
+# it starts from; the stretch before the first checkpoint is "start".
+def phaseTimes(checkpoints):
+  times = {}
+  last, phase = 0, "start"
+  for cp in checkpoints:
+    times[phase] = times.get(phase, 0) + cp[0] - last
+    last, phase = cp[0], PHASES[cp[1]]
+  return times
+
+def seconds(frames):
+  return frames / 1000.0
+
+# Where two report streams part, from their running hashes: the reports up to
+# the first hash that differs, or None if they are the same.
+def parting(keys, otherKeys):
+  last = 0
+  for key, other in zip(keys, otherKeys):
+    if key != other:
+      return last, key[0]
+    last = key[0]
+  if len(keys) != len(otherKeys):
+    return last, None
+  return None
+
+def describeParting(part):
+  if part is None:
+    return "same reports"
+  if part[1] is None:
+    return "same for the first {} reports".format(part[0])
+  return "differ in reports {} to {}".format(part[0] + 1, part[1])
+
+# A changes-only trace as (frame, report), the report as the rest of the line.
+def readTrace(path):
+  with open(path) as f:
+    return [(int(line.split(None, 1)[0]), line.split(None, 1)[1].strip()) for line in f]
+
+# profile.py is loaded by path, as the standard library has a profile module.
+def loadProfile():
+  spec = importlib.util.spec_from_file_location("hostprofile", os.path.join(HOST_DIR, "profile.py"))
+  module = importlib.util.module_from_spec(spec)
+  spec.loader.exec_module(module)
+  return module
+
+# The phase the source is in from each frame on, from its marks, as the frames
+# and the phases, nested phases joined by "/".
+def phaseSpans(path):
+  names = loadProfile().phaseNames(os.path.join(HOST_DIR, "..", "Profile.h"))
+  frames, phases, stack = [0], ["job"], []
+  with open(path) as f:
+    for line in f:
+      frame, reports, mark = (int(v) for v in line.split())
+      if mark == 0:
+        break
+      if mark & 0x40:
+        stack.append(names[mark & 0x3F])
+      elif stack:
+        stack.pop()
+      frames.append(frame)
+      phases.append("/".join(stack) or "job")
+  return frames, phases
+
+def phaseAt(spans, frame):
+  return spans[1][bisect.bisect_right(spans[0], frame) - 1]
+
+# How far ahead the inputs of the source and the image are searched for the
+# point where they agree again after parting, and how many changes in a row
+# they must then agree on.
+RESYNC_AHEAD = 400
+RESYNC_RUN = 8
+
+# Match the inputs of two traces change for change, timing aside. Returns the
+# pairs of changes matched, and the stretches in between where the inputs
+# part, as (source from, to, image from, to).
+def alignTraces(source, image):
+  pairs, parts = [], []
+  i = j = 0
+  while i < len(source) and j < len(image):
+    if source[i][1] == image[j][1]:
+      pairs.append((i, j))
+      i, j = i + 1, j + 1
+      continue
+    ahead = {}
+    for b in range(min(RESYNC_AHEAD, len(image) - j - RESYNC_RUN) + 1):
+      ahead.setdefault(tuple(r for f, r in image[j + b:j + b + RESYNC_RUN]), b)
+    best = None
+    for a in range(min(RESYNC_AHEAD, len(source) - i - RESYNC_RUN) + 1):
+      b = ahead.get(tuple(r for f, r in source[i + a:i + a + RESYNC_RUN]))
+      if b is not None and (best is None or a + b < sum(best)):
+        best = (a, b)
+    if best is None:
+      break
+    parts.append((i, i + best[0], j, j + best[1]))
+    i, j = i + best[0], j + best[1]
+  if i < len(source) or j < len(image):
+    parts.append((i, len(source), j, len(image)))
+  return pairs, parts
+
+# Print where the source's inputs and their timing part from the image's:
+# each stretch where they press different things, with the source's phase,
+# and, over the inputs they share, the phases the image took a different
+# time over.
+def printTraceParting(traces, imageTrace):
+  source, image, spans = readTrace(traces[0]), readTrace(imageTrace), phaseSpans(traces[1])
+  pairs, parts = alignTraces(source, image)
+  print("    {} of {} input changes the same as the image's, parting in {} places".format(
+      len(pairs), len(source), len(parts)))
+
+  def at(trace, i):
+    return trace[i][0] if i < len(trace) else trace[-1][0]
+  for i, iEnd, j, jEnd in parts[:3]:
+    print("    inputs part at {:.1f}s in {}: {} changes, the image {} from {:.1f}s".format(
+        seconds(at(source, i)), phaseAt(spans, at(source, i)), iEnd - i, jEnd - j,
+        seconds(at(image, j))))
+  if len(parts) > 3:
+    print("    ...")
+
+  for i, j in pairs:
+    if source[i][0] != image[j][0]:
+      print("    timing parts at {:.3f}s in {}: the image makes the same change at {:.3f}s".format(
+          seconds(source[i][0]), phaseAt(spans, source[i][0]), seconds(image[j][0])))
+      break
+
+  # Each step from one matched change to the next, and each stretch where the
+  # inputs part, counts to the source's phase at its start.
+  times = {}
+  steps = [(i, i + 1, j, j + 1) for i, j in pairs] + parts
+  for i, iEnd, j, jEnd in steps:
+    took = times.setdefault(phaseAt(spans, at(source, i)), [0, 0])
+    took[0] += at(source, iEnd) - at(source, i)
+    took[1] += at(image, jEnd) - at(image, j)
+  parted = sorted(times.items(), key=lambda t: -abs(t[1][1] - t[1][0]))
+  for phase, (frames, imageFrames) in [t for t in parted if t[1][0] != t[1][1]][:5]:
+    print("    {:<32} {:>9.1f}s  image {:.1f}s, {:+.1f}s".format(phase, seconds(frames),
+        seconds(imageFrames), seconds(frames - imageFrames)))
+
+# Print how the source's job compares with the image's golden, and, if the
+# image was run, where their inputs part. The source was changed on purpose
+# since the images were built, so this never fails.
+def compareImage(golden, summary, traces, imageTrace):
+  imageSummary, imageKeys = golden
+  imageFrames, frames = int(field(imageSummary, "frames")), int(field(summary, "frames"))
+  if imageFrames >= UNPLUG_AT:
+    timing = "image runs until unplugged"
+  else:
+    timing = "image {:.1f}s, {:+.1f}s".format(seconds(imageFrames), seconds(frames - imageFrames))
+  print("    {:<26} {}".format("against the image", timing))
+  if imageTrace is not None:
+    printTraceParting(traces, imageTrace)
+
+# Print how an image's run differs from its golden, returning whether it
+# matches. Only a change to Image or to the image can make it differ.
+def checkImage(image, golden, summary, keys):
+  goldSummary, goldKeys = golden
+  if goldSummary == summary and goldKeys == keys:
+    print("  {:<28} {:>9.1f}s  image same".format(image, seconds(int(field(summary, "frames")))))
+    return True
+  print("  {:<28} {:>9.1f}s  image was {:.1f}s, {}".format(image,
+      seconds(int(field(summary, "frames"))), seconds(int(field(goldSummary, "frames"))),
+      describeParting(parting(keys, goldKeys))))
+  return False
+
+# Print how a run differs from its golden, returning whether it matches.
+def compare(image, golden, now):
+  (goldSummary, goldCps), (nowSummary, nowCps) = golden, now
+  if field(goldSummary, "hash") == field(nowSummary, "hash") and goldCps == nowCps:
+    print("  {:<28} {:>9.1f}s  same".format(image, seconds(int(field(nowSummary, "frames")))))
+    return True
+
+  goldFrames, nowFrames = int(field(goldSummary, "frames")), int(field(nowSummary, "frames"))
+  print("  {:<28} {:>9.1f}s  was {:.1f}s, {:+.1f}s".format(image, seconds(nowFrames),
+      seconds(goldFrames), seconds(nowFrames - goldFrames)))
+  goldTimes, nowTimes = phaseTimes(goldCps), phaseTimes(nowCps)
+  for phase in ["start"] + PHASES:
+    if phase in goldTimes or phase in nowTimes:
+      gold, now = goldTimes.get(phase, 0), nowTimes.get(phase, 0)
+      if gold != now:
+        print("    {:<12} {:>9.1f}s  was {:.1f}s, {:+.1f}s".format(phase, seconds(now),
+            seconds(gold), seconds(now - gold)))
+  for i, (gold, now) in enumerate(zip(goldCps, nowCps)):
+    if gold != now:
+      print("    first difference at checkpoint {}: {} now {}".format(i, gold, now))
+      break
+  if len(goldCps) != len(nowCps):
+    print("    {} checkpoints, was {}".format(len(nowCps), len(goldCps)))
+  return False
+
+def main(argv):
+  opts, args = getopt.getopt(argv, "hui")
+
+  update = False
+  images = False
+  for opt, arg in opts:
+    if opt == '-h':
+      usage()
+      sys.exit()
+    elif opt == '-u':
+      update = True
+    elif opt == '-i':
+      images = True
+
+  jobs = [(image, params) for image, params in IMAGES + JOBS if not args or image in args]
+  same = True
+  imageTraces = {}
+  with tempfile.TemporaryDirectory() as workDir:
+    if images:
+      for image, params in [job for job in jobs if job in IMAGES]:
+        summary, keys, imageTraces[image] = runImage(image, workDir)
+        path = imageGoldenPath(image)
+        if update:
+          os.makedirs(IMAGE_GOLDEN_DIR, exist_ok=True)
+          writeImage(path, image, summary, keys)
+          print("  {:<28} {:>9.1f}s  image written".format(image, seconds(int(field(summary, "frames")))))
+        elif not os.path.exists(path):
+          print("  {:<28} no image golden, run golden.py -u -i".format(image))
+          same = False
+        else:
+          same &= checkImage(image, readImage(path), summary, keys)
+
+    for image, params in jobs:
+      summary, checkpoints, keys, traces = run(image, params, workDir, image in imageTraces)
+      path = goldenPath(image)
+      if update:
+        write(path, image, params, summary, checkpoints)
+        print("  {:<28} {:>9.1f}s  written".format(image, seconds(int(field(summary, "frames")))))
+      elif not os.path.exists(path):
+        print("  {:<28} no golden, run golden.py -u".format(image))
+        same = False
+      else:
+        same &= compare(image, read(path), (summary, checkpoints))
+      if os.path.exists(imageGoldenPath(image)):
+        compareImage(readImage(imageGoldenPath(image)), summary, traces, imageTraces.get(image))
+  if not same:
+    sys.exit(1)
+
+def usage():
+  print("To check each HexFiles/ job against its golden timeline: golden.py [options] [image...]")
+  print("  -u   write the goldens from this tree instead")
+  print("  -i   also run the images themselves and check, or with -u write, their goldens")
+  print("Images are named as under HexFiles/, e.g. Hatching/5-cycle; all are run by default,")
+  print("with the jobs in JOBS.")
+  print("A job that differs from its golden prints its runtime and time in each phase")
+  print("against the golden, and golden.py exits with 1. Each job is then set against")
+  print("its image's runtime. With -i, it also prints where the job's inputs first part")
+  print("from the image's, and where their timing does, in which phase of the job, and")
+  print("the phases whose inputs the image took a different time over.")
+
+if __name__ == "__main__":
+  main(sys.argv[1:])
@@ -0,0 +1,47 @@
+// Host stand-in for the parts of LUFA's USB device API the firmware uses.
+// host/Host.c implements it as an emulated host; see there.
+#ifndef _HOST_USB_H_
+#define _HOST_USB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ATTR_WARN_UNUSED_RESULT
+#define ATTR_NON_NULL_PTR_ARG(...)
+
+#define ENDPOINT_DIR_IN   0x80
+#define ENDPOINT_DIR_OUT  0x00
+#define EP_TYPE_INTERRUPT 0x03
+
+enum USB_Device_States_t {
+	DEVICE_STATE_Unattached,
+	DEVICE_STATE_Powered,
+	DEVICE_STATE_Default,
+	DEVICE_STATE_Addressed,
+	DEVICE_STATE_Configured,
+	DEVICE_STATE_Suspended
+};
+
+// Descriptors aren't built on the host; Descriptors.h only needs the names.
+typedef struct { uint8_t Size; } USB_Descriptor_Configuration_Header_t;
+typedef struct { uint8_t Size; } USB_Descriptor_Interface_t;
+typedef struct { uint8_t Size; } USB_HID_Descriptor_HID_t;
+typedef struct { uint8_t Size; } USB_Descriptor_Endpoint_t;
+
+extern volatile uint8_t USB_DeviceState;
+
+void USB_Init(void);
+void USB_USBTask(void);
+void USB_Device_EnableSOFEvents(void);
+void GlobalInterruptEnable(void);
+
+bool Endpoint_ConfigureEndpoint(uint8_t address, uint8_t type, uint16_t size, uint8_t banks);
+uint8_t Endpoint_GetCurrentEndpoint(void);
+void Endpoint_SelectEndpoint(uint8_t address);
+bool Endpoint_IsOUTReceived(void);
+void Endpoint_ClearOUT(void);
+bool Endpoint_IsINReady(void);
+void Endpoint_ClearIN(void);
+void Endpoint_Write_8(uint8_t data);
+
+#endif
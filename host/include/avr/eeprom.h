@@ -0,0 +1,11 @@
+// Host stand-in for avr-libc. Addresses index the host's EEPROM image.
+#ifndef _HOST_EEPROM_H_
+#define _HOST_EEPROM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+void eeprom_read_block(void* dst, const void* src, size_t n);
+void eeprom_update_block(const void* src, void* dst, size_t n);
+
+#endif
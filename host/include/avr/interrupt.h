@@ -0,0 +1,8 @@
+// Host stand-in for avr-libc. The "interrupts" are called from sleep_mode().
+#ifndef _HOST_INTERRUPT_H_
+#define _HOST_INTERRUPT_H_
+
+#define sei()
+#define cli()
+
+#endif
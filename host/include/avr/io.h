@@ -0,0 +1,10 @@
+// Host stand-in for avr-libc: the registers the firmware touches.
+#ifndef _HOST_IO_H_
+#define _HOST_IO_H_
+
+#include <stdint.h>
+
+extern uint8_t MCUSR, DDRB, PORTB, DDRD, PORTD;
+#define WDRF 3
+
+#endif
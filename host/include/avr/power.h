@@ -0,0 +1,8 @@
+// Host stand-in for avr-libc.
+#ifndef _HOST_POWER_H_
+#define _HOST_POWER_H_
+
+#define clock_div_1 0
+#define clock_prescale_set(div)
+
+#endif
@@ -0,0 +1,9 @@
+// Host stand-in for avr-libc. sleep_mode() lets one USB frame go by.
+#ifndef _HOST_SLEEP_H_
+#define _HOST_SLEEP_H_
+
+#define SLEEP_MODE_IDLE 0
+#define set_sleep_mode(mode)
+void sleep_mode(void);
+
+#endif
@@ -0,0 +1,7 @@
+// Host stand-in for avr-libc.
+#ifndef _HOST_WDT_H_
+#define _HOST_WDT_H_
+
+#define wdt_disable()
+
+#endif
@@ -0,0 +1,16 @@
+// Host stand-in for avr-libc.
+#ifndef _HOST_CRC16_H_
+#define _HOST_CRC16_H_
+
+#include <stdint.h>
+
+// Dallas/iButton CRC-8, as in avr-libc.
+static inline uint8_t _crc_ibutton_update(uint8_t crc, uint8_t data) {
+	uint8_t i;
+	crc ^= data;
+	for (i = 0; i < 8; i++)
+		crc = (crc & 0x01) ? (crc >> 1) ^ 0x8C : crc >> 1;
+	return crc;
+}
+
+#endif
@@ -0,0 +1,7 @@
+// Host stand-in for avr-libc.
+#ifndef _HOST_DELAY_H_
+#define _HOST_DELAY_H_
+
+#define _delay_ms(ms)
+
+#endif
@@ -0,0 +1,131 @@
+#!/bin/python
+
+import sys, os, getopt, re
+
+HOST_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# Phase names, from Phase_t in Profile.h: PHASE_HATCH_WALK is hatch_walk.
+def phaseNames(header):
+  with open(header) as f:
+    body = re.search(r"typedef enum \{(.*?)\} Phase_t;", f.read(), re.S).group(1)
+  names = re.findall(r"^\s*PHASE_(\w+)", body, re.M)
+  return [name.lower() for name in names]
+
+class Node:
+  def __init__(self, name):
+    self.name = name
+    self.frames = 0
+    self.reports = 0
+    self.calls = 0
+    self.children = {}
+
+  def child(self, name):
+    if name not in self.children:
+      self.children[name] = Node(name)
+    return self.children[name]
+
+  def selfFrames(self):
+    return self.frames - sum(c.frames for c in self.children.values())
+
+# Build the phase tree from the marks Joystick -m wrote: frame reports mark,
+# with the job's end as a 0 mark. Marks as in Profile.h.
+def readMarks(path, names):
+  root = Node("job")
+  stack = [(root, 0, 0)]
+  end = None
+  with open(path) as f:
+    for n, line in enumerate(f, 1):
+      frame, reports, mark = (int(v) for v in line.split())
+      if mark == 0:
+        end = (frame, reports)
+        break
+      name = names[mark & 0x3F]
+      if mark & 0x40:
+        stack.append((stack[-1][0].child(name), frame, reports))
+      elif stack[-1][0].name != name or len(stack) == 1:
+        print("ERROR: {}:{}: {} ends inside {}".format(path, n, name, stack[-1][0].name))
+        sys.exit(1)
+      else:
+        node, start, startReports = stack.pop()
+        node.frames += frame - start
+        node.reports += reports - startReports
+        node.calls += 1
+  if end is None:
+    print("ERROR: {} ends before the job did".format(path))
+    sys.exit(1)
+  if len(stack) > 1:
+    print("ERROR: {} still open at the end of the job".format(stack[-1][0].name))
+    sys.exit(1)
+  # The marks after the last input come up as the next report is made, which
+  # is after the job's last report; they end with the job.
+  root.frames, root.reports = end
+  clamp(root, root.frames, root.reports)
+  root.calls = 1
+  return root
+
+def clamp(node, frames, reports):
+  for c in node.children.values():
+    c.frames = min(c.frames, frames)
+    c.reports = min(c.reports, reports)
+    clamp(c, c.frames, c.reports)
+
+def seconds(frames):
+  return frames / 1000.0
+
+def printTree(node, total, depth, maxDepth):
+  print("  {:<26} {:>10.1f}s {:>6.1f}% {:>9} {:>7} {:>10.1f}s".format(
+      "  " * depth + node.name, seconds(node.frames), 100.0 * node.frames / total,
+      node.reports, node.calls, seconds(node.selfFrames())))
+  if depth + 1 > maxDepth:
+    return
+  for c in sorted(node.children.values(), key=lambda c: -c.frames):
+    printTree(c, total, depth + 1, maxDepth)
+
+# One line per stack, with its self time in ms, for flamegraph.pl.
+def printFolded(node, path):
+  path = path + [node.name]
+  if node.selfFrames() > 0:
+    print("{} {}".format(";".join(path), node.selfFrames()))
+  for c in sorted(node.children.values(), key=lambda c: c.name):
+    printFolded(c, path)
+
+def main(argv):
+  opts, args = getopt.getopt(argv, "hfd:s:")
+
+  folded = False
+  maxDepth = 1000
+  header = os.path.join(HOST_DIR, "..", "Profile.h")
+  for opt, arg in opts:
+    if opt == '-h':
+      usage()
+      sys.exit()
+    elif opt == '-f':
+      folded = True
+    elif opt == '-d':
+      maxDepth = int(arg, 0)
+    elif opt == '-s':
+      header = os.path.join(arg, "Profile.h")
+  if len(args) != 1:
+    usage()
+    sys.exit(1)
+
+  root = readMarks(args[0], phaseNames(header))
+  if folded:
+    printFolded(root, [])
+    return
+
+  print("  {:<26} {:>11} {:>7} {:>9} {:>7} {:>11}".format(
+      "phase", "time", "of job", "reports", "calls", "self"))
+  printTree(root, max(root.frames, 1), 0, maxDepth)
+
+def usage():
+  print("To break a job's time down by phase: profile.py [options] marks")
+  print("  -f       print folded stacks for flamegraph.pl instead, in ms")
+  print("  -d n     only show phases n deep")
+  print("  -s dir   firmware source directory (default ..)")
+  print("The marks are written by the host build with Joystick -m marks. Each phase")
+  print("shows its time, share of the job, reports, times entered and the time spent")
+  print("outside the phases within it. The job's own self time is outside any phase.")
+
+if __name__ == "__main__":
+  main(sys.argv[1:])
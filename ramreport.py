@@ -0,0 +1,71 @@
+#!/bin/python
+
+import sys, getopt, subprocess
+
+# Sections that are placed in SRAM. Whatever is left is shared by the heap and
+# the stack, which grows down from the top of SRAM.
+RAM_SECTIONS = [".data", ".bss", ".noinit"]
+
+def sections(elf, size):
+  # avr-size -A prints "section size address" for every section.
+  totals = dict((name, 0) for name in RAM_SECTIONS)
+  out = subprocess.check_output([size, "-A", elf]).decode()
+  for line in out.splitlines():
+    fields = line.split()
+    if len(fields) == 3 and fields[0] in totals:
+      totals[fields[0]] = int(fields[1])
+  return totals
+
+def symbols(elf, nm):
+  # avr-nm -S prints "address size type name"; d/D are .data and b/B .bss.
+  syms = []
+  out = subprocess.check_output([nm, "-S", "-t", "d", "--size-sort", elf]).decode()
+  for line in out.splitlines():
+    fields = line.split()
+    if len(fields) == 4 and fields[2] in "dDbB":
+      section = ".data" if fields[2] in "dD" else ".bss"
+      syms.append((int(fields[1]), section, fields[3]))
+  return sorted(syms, reverse=True)
+
+def main(argv):
+  opts, args = getopt.getopt(argv, "hr:m:p:")
+
+  ramSize = 512
+  headroom = 128
+  prefix = "avr-"
+  for opt, arg in opts:
+    if opt == '-h':
+      usage()
+      sys.exit()
+    elif opt == '-r':
+      ramSize = int(arg, 0)
+    elif opt == '-m':
+      headroom = int(arg, 0)
+    elif opt == '-p':
+      prefix = arg
+  if len(args) != 1:
+    usage()
+    sys.exit(1)
+
+  elf = args[0]
+  for size, section, name in symbols(elf, prefix + "nm"):
+    print("  {:>5} {:<7} {}".format(size, section, name))
+
+  totals = sections(elf, prefix + "size")
+  used = sum(totals.values())
+  free = ramSize - used
+  print("")
+  print("  " + ", ".join("{} {}".format(name, totals[name]) for name in RAM_SECTIONS))
+  print("  {} of {} bytes of SRAM used, {} left for the stack (need {})".format(used, ramSize, free, headroom))
+  if free < headroom:
+    print("ERROR: Only {} bytes of SRAM left for the stack, below the {} byte minimum".format(free, headroom))
+    sys.exit(1)
+
+def usage():
+  print("To report static SRAM use: ramreport.py [options] Joystick.elf")
+  print("  -r bytes   SRAM size of the MCU (default 512, the atmega16u2)")
+  print("  -m bytes   fail if less than this is left for the stack (default 128)")
+  print("  -p prefix  toolchain prefix (default avr-)")
+
+if __name__ == "__main__":
+  main(sys.argv[1:])
@@ -0,0 +1,616 @@
+#!/bin/python
+
+import sys, os, re, getopt
+
+# Works out what a job costs from the sequence tables in Joystick.c, without
+# building or running anything. The constants are read from the sources, so
+# an edited table or loop bound is costed as it stands. The job code in main()
+# and the cursor planning in Box.c are mirrored below; keep them in step.
+
+MODES = ["COLLECTING", "COLLECT_THEN_HATCH", "HATCHING", "RELEASING", "COLLECT_AND_HATCH"]
+
+# CheckpointPhase_t in Checkpoint.h.
+CHECKPOINT_NONE, CHECKPOINT_COLLECT, CHECKPOINT_HATCH_START, CHECKPOINT_HATCH, \
+    CHECKPOINT_PIPELINE, CHECKPOINT_RELEASE = range(6)
+
+# ---------------------------------------------------------------------------
+# Reading the sources
+
+def readSource(path):
+  with open(path) as f:
+    text = f.read()
+  text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+  return re.sub(r"//[^\n]*", "", text)
+
+def evaluate(expr, defines):
+  expr = re.sub(r"\(\s*u?int\d+_t\s*\)", "", expr)
+  expr = re.sub(r"\b[A-Za-z_]\w*\b", lambda m: str(defines.get(m.group(0), m.group(0))), expr)
+  return int(eval(expr.replace("/", "//"), {"__builtins__": {}}))
+
+# Integer #defines and enum values, resolved against each other.
+def readConstants(texts):
+  raw = {}
+  defines = {}
+  for text in texts:
+    for name, value in re.findall(r"#define\s+(\w+)[ \t]+([^\n]+)", text):
+      raw[name] = value.strip()
+    for body in re.findall(r"enum\s*\{(.*?)\}", text, flags=re.S):
+      value = 0
+      for entry in body.split(","):
+        name, _, init = entry.partition("=")
+        name = name.strip()
+        if not name:
+          continue
+        if init.strip():
+          value = evaluate(init, defines)
+        defines[name] = value
+        value += 1
+  for _ in range(8):
+    for name, value in raw.items():
+      if name in defines:
+        continue
+      try:
+        defines[name] = evaluate(value, defines)
+      except Exception:
+        pass
+  return defines
+
+def splitArgs(text):
+  items, depth, current = [], 0, ""
+  for c in text:
+    if c == "," and depth == 0:
+      items.append(current.strip())
+      current = ""
+      continue
+    depth += (c == "(") - (c == ")")
+    current += c
+  if current.strip():
+    items.append(current.strip())
+  return items
+
+# Every PROGMEM sequence, as a list of (op, args), and the sequences[] table.
+def readSequences(text, defines):
+  sequences = {}
+  for name, body in re.findall(r"static const uint8_t PROGMEM (\w+)\[\]\s*=\s*\{(.*?)\};", text, flags=re.S):
+    steps = []
+    for item in splitArgs(body):
+      m = re.match(r"(\w+)(?:\((.*)\))?$", item, flags=re.S)
+      op, args = m.group(1), m.group(2)
+      steps.append((op, [a if re.match(r"^(SEQ|VAR|TRACK)_", a) else evaluate(a, defines)
+          for a in splitArgs(args)] if args is not None else []))
+    sequences[name] = steps
+  # An entry is the sequence, or JOB_SEQ(job, sequence) to leave it out of
+  # other jobs' fixed builds.
+  table = dict(re.findall(r"\[(SEQ_\w+)\]\s*=\s*(?:JOB_SEQ\([^,]*,\s*)?(\w+)", re.search(r"sequences\[\] PROGMEM = \{(.*?)\};", text, flags=re.S).group(1)))
+  return sequences, table
+
+# ---------------------------------------------------------------------------
+# Timing model of nextMove() and GetNextReport()
+
+class Timeline:
+  def __init__(self, c, poll):
+    self.c = c
+    self.poll = poll
+    self.minPolls = (1000 + c["FRAME_RATE"] * poll - 1) // (c["FRAME_RATE"] * poll)
+    # Reports go out at every poll. The first poll sends the initial report
+    # and the state machine takes two more before commands play. The host is
+    # taken to poll at poll ms from the start; the firmware assumes
+    # DEFAULT_POLL_MS until it has measured it, which can move the end of
+    # pairing by a few polls.
+    self.next = 4 * poll
+    self.end = 0
+    self.syncTime = 2 * poll
+    self.taken = []
+    self.background = None
+    self.costs = {}
+    self.label = "start"
+
+  def ms(self, frames):
+    return (frames * 1000 + self.c["FRAME_RATE"] // 2) // self.c["FRAME_RATE"]
+
+  # Report frame at which main() last woke, having queued everything so far.
+  # It runs up to QUEUE_SIZE - 1 commands ahead of the one being reported.
+  def now(self):
+    ahead = self.c["QUEUE_SIZE"] - 1
+    if len(self.taken) <= ahead:
+      return self.syncTime
+    return max(self.syncTime, self.taken[-ahead - 1])
+
+  def charge(self, start):
+    self.costs[self.label] = self.costs.get(self.label, 0) + self.next - start
+
+  # A command is reported until its time on the frame timeline is up and it
+  # has been in minPolls reports.
+  def press(self, frames):
+    if frames == 0:
+      return
+    start = self.next
+    self.end += self.ms(frames)
+    polls = max(self.minPolls, -(-(self.end - start) // self.poll))
+    self.taken.append(start)
+    self.next = start + polls * self.poll
+    self.charge(start)
+
+  def startBackground(self, steps):
+    self.background = (self.now(), steps)
+
+  # The background track plays its loop from the report after it was started
+  # until the input under way when it is stopped is done. Returns the report
+  # frame it goes idle at.
+  def stopBackground(self):
+    started, steps = self.background
+    stopped = self.now()
+    self.background = None
+    end, at, i = started, started + self.poll, 0
+    while True:
+      end += self.ms(steps[i % len(steps)])
+      polls = max(self.minPolls, -(-(end - at) // self.poll))
+      at += polls * self.poll
+      i += 1
+      if at > stopped:
+        return at
+
+  # Every track done, as flushCommands() and SYNC wait for. The last report
+  # is empty, and the timeline starts again from it.
+  def sync(self, idle=0):
+    # Nothing has been queued since the last time.
+    if not self.taken and not idle:
+      return
+    start = self.next
+    self.syncTime = max(self.next, idle)
+    self.end = self.syncTime
+    self.next = self.syncTime + self.poll
+    self.taken = []
+    self.charge(start)
+
+  # USB frame main() is at, as checkpoints and the end of the job are seen.
+  def frame(self):
+    return self.now() - self.poll
+
+# ---------------------------------------------------------------------------
+# The job, mirroring main(), Box.c and the job functions in Joystick.c
+
+class Job:
+  def __init__(self, c, sequences, table, settings, poll):
+    self.c = c
+    self.sequences = sequences
+    self.table = table
+    self.s = settings
+    self.t = Timeline(c, poll)
+    self.var = dict((name, 0) for name in c if name.startswith("VAR_"))
+    self.checkpoints = []
+    self.phase = "start"
+    self.boxMap = [0] * c["MAP_BOXES"]
+    self.partial = (0, 0, 0)
+    self.keep = False
+    # Report frame the background track goes idle at, once stopped.
+    self.idle = 0
+
+  def setPhase(self, phase, label=None):
+    self.phase = phase
+    self.t.label = phase + "/" + (label or phase)
+
+  # Play a sequence, costed under its name or label. Sequences it calls are
+  # costed under their own names, unless keep.
+  def run(self, name, label=None, keep=False):
+    outer, outerKeep = self.t.label, self.keep
+    if not self.keep:
+      self.t.label = self.phase + "/" + (label or name)
+    self.keep = keep or self.keep
+    self.play(self.sequences[name])
+    self.t.label, self.keep = outer, outerKeep
+
+  def runId(self, seqId):
+    self.run(self.table[seqId])
+
+  def play(self, steps):
+    loops = []
+    i = 0
+    while True:
+      op, args = steps[i]
+      i += 1
+      if op in ("REPEAT", "REPEAT_VAR"):
+        count = args[0] if op == "REPEAT" else self.var[args[0]] + args[1]
+        if count == 0:
+          depth = 1
+          while depth:
+            depth += steps[i][0] in ("REPEAT", "REPEAT_VAR")
+            depth -= steps[i][0] == "NEXT"
+            i += 1
+        else:
+          loops.append([i, count])
+      elif op == "NEXT":
+        loops[-1][1] -= 1
+        if loops[-1][1]:
+          i = loops[-1][0]
+        else:
+          loops.pop()
+      elif op == "CALL":
+        self.runId(args[0])
+      elif op == "BACKGROUND":
+        name = self.table[args[1]]
+        self.t.startBackground([a[-1] for op, a in self.sequences[name] if op in ("PRESS", "WAIT")])
+      elif op == "STOP":
+        self.idle = self.t.stopBackground()
+      elif op == "SYNC":
+        self.t.sync(self.idle)
+        self.idle = 0
+      elif op == "RETURN":
+        return
+      elif op == "PRESS":
+        self.t.press(args[1])
+      elif op == "WAIT":
+        self.t.press(args[0])
+      else:
+        raise ValueError("can't cost {} in a sequence".format(op))
+
+  def command(self, frames):
+    self.t.press(frames)
+
+  # saveCheckpoint() lets everything queued play out first.
+  def saveCheckpoint(self, phase, count, box, col):
+    self.t.sync()
+    self.checkpoints.append((self.t.frame(), phase, count, box, col))
+
+  # Box.c
+  def press(self, times, label="box/cursor"):
+    outer = self.t.label
+    self.t.label = self.phase + "/" + label
+    for _ in range(times):
+      self.command(8)
+      self.command(15)
+    self.t.label = outer
+
+  def stepRing(self, frm, to, size):
+    ahead = (to + size - frm) % size
+    self.press(ahead if ahead <= size - ahead else size - ahead)
+
+  def grab(self, count):
+    outer = self.t.label
+    self.t.label = self.phase + "/box/grab"
+    for _ in range(count + 1):
+      self.command(8)
+      self.command(8)
+    self.t.label = outer
+
+  def openBox(self, seqId="SEQ_OPEN_BOX", mode="BOX_MULTISELECT"):
+    self.run(self.table[seqId], "box/open", True)
+    self.cursor = [0, 0, self.c[mode]]
+
+  def useMode(self, mode):
+    n = self.c["NUM_BOX_MODES"]
+    self.press((self.c[mode] + n - self.cursor[2]) % n, "box/mode")
+    self.cursor[2] = self.c[mode]
+
+  def moveTo(self, row, col):
+    rows, cols, party = self.c["BOX_ROWS"], self.c["BOX_COLUMNS"], self.c["BOX_PARTY"]
+    cRow, cCol = self.cursor[0], self.cursor[1]
+    if cCol == party and col == party:
+      self.press(abs(row - cRow))
+    elif cCol == party:
+      self.stepRing(cCol, col, cols + 1)
+      self.stepRing(min(cRow, rows - 1), row, rows + 1)
+    else:
+      boxRow = min(row, rows - 1)
+      self.stepRing(cRow, boxRow, rows + 1)
+      self.stepRing(cCol, col, cols + 1)
+      self.press(row - boxRow)
+    self.cursor[0], self.cursor[1] = row, col
+
+  def columnToParty(self, col):
+    self.moveTo(0, col)
+    self.useMode("BOX_MULTISELECT")
+    self.grab(self.c["BOX_ROWS"])
+    self.moveTo(1, self.c["BOX_PARTY"])
+    self.press(1, "box/grab")
+
+  def partyToColumn(self, col, count):
+    self.moveTo(1, self.c["BOX_PARTY"])
+    self.useMode("BOX_MULTISELECT")
+    self.grab(count)
+    self.moveTo(0, col)
+    self.press(1, "box/grab")
+
+  def releaseStart(self, row, col):
+    self.moveTo(row, col)
+    self.useMode("BOX_NORMAL")
+    self.runId("SEQ_RELEASE")
+
+  def releaseEnd(self):
+    self.runId("SEQ_RELEASE_DIALOGUE")
+
+  def release(self, row, col):
+    self.releaseStart(row, col)
+    self.releaseEnd()
+
+  def releaseColumn(self, box, col, keep):
+    for row in range(self.mapEggs(box, col)):
+      if not keep & (1 << row):
+        self.release(row, col)
+
+  def nextBox(self):
+    self.press(1, "box/switch")
+
+  def prevBox(self):
+    self.press(1, "box/switch")
+
+  def mapAdd(self, box, col, eggs):
+    if box >= len(self.boxMap) or eggs == 0:
+      return
+    self.boxMap[box] |= 1 << col
+    if eggs < self.c["BOX_ROWS"]:
+      self.partial = (box, col, eggs)
+
+  def mapEggs(self, box, col):
+    if box >= len(self.boxMap) or not self.boxMap[box] & (1 << col):
+      return 0
+    if self.partial[2] and (box, col) == self.partial[:2]:
+      return self.partial[2]
+    return self.c["BOX_ROWS"]
+
+  def mapNext(self, box, col):
+    while box < len(self.boxMap):
+      while col < self.c["BOX_COLUMNS"]:
+        eggs = self.mapEggs(box, col)
+        if eggs:
+          return box, col, eggs
+        col += 1
+      box, col = box + 1, 0
+    return box, col, 0
+
+  # Joystick.c
+  def hatchPasses(self):
+    if self.s["hatchPasses"]:
+      return self.s["hatchPasses"]
+    steps = self.s["eggCycles"] * self.c["STEPS_PER_CYCLE"]
+    if self.s["flameBody"]:
+      steps = (steps + 1) // 2
+    return (steps + self.c["STEPS_PER_PASS"] - 1) // self.c["STEPS_PER_PASS"] + 1
+
+  def pipelinePasses(self):
+    passes = (self.hatchPasses() + self.c["PARTY_EGGS"] - 1) // self.c["PARTY_EGGS"] + self.c["HATCH_DIALOGUE_PASSES"]
+    return max(passes, self.s["collectPasses"])
+
+  def pair(self):
+    self.setPhase("pair", "hold")
+    start = self.t.frame()
+    while self.t.frame() - start < self.t.ms(self.c["PAIR_HOLD"]):
+      self.command(self.c["PAIR_STEP"])
+    self.run("pairConfirm")
+    self.t.sync()
+    # A host that sends no OUT reports is taken to be quiet already.
+
+  def collect(self):
+    self.run("walkAndHatch", "walk", True)
+    self.run("takeEgg", "day care")
+    self.var["VAR_ROW"] += 1
+    if self.var["VAR_ROW"] == self.c["PARTY_EGGS"]:
+      self.storeParty()
+
+  def storeParty(self):
+    self.setPhase("store")
+    self.openBox()
+    self.partyToColumn(self.var["VAR_COLUMN"], self.var["VAR_ROW"])
+    self.mapAdd(self.var["VAR_BOXES_FORWARD"], self.var["VAR_COLUMN"], self.var["VAR_ROW"])
+    self.var["VAR_ROW"] = 0
+    self.var["VAR_COLUMN"] += 1
+    if self.var["VAR_COLUMN"] > 5:
+      self.nextBox()
+      self.var["VAR_COLUMN"] = 0
+      self.var["VAR_BOXES_FORWARD"] += 1
+    self.runId("SEQ_CLOSE_MENUS")
+    self.setPhase("collect")
+
+  def hatch(self):
+    box, col, eggs = self.mapNext(0, 0)
+    if eggs == 0:
+      return
+    self.setPhase("hatch")
+    self.openBox()
+    for _ in range(box):
+      self.nextBox()
+    self.columnToParty(col)
+    self.runId("SEQ_CLOSE_BOX")
+    self.saveCheckpoint(CHECKPOINT_HATCH, 0, box, col)
+    while eggs:
+      self.var["VAR_PARTY_EGGS"] = eggs
+      self.runHatchParty()
+      self.openBox()
+      self.partyToColumn(col, eggs)
+      if self.s["releaseHatched"]:
+        self.releaseColumn(box, col, self.s["keepSlots"][col])
+      nextBox, col, eggs = self.mapNext(box, col + 1)
+      if eggs:
+        for _ in range(box, nextBox):
+          self.nextBox()
+        box = nextBox
+        self.columnToParty(col)
+      self.runId("SEQ_CLOSE_BOX")
+      if eggs:
+        self.saveCheckpoint(CHECKPOINT_HATCH, 0, box, col)
+
+  # hatchParty, split into the walk that hatches the eggs and the walk that
+  # covers their dialogues.
+  def runHatchParty(self):
+    steps = self.sequences[self.table["SEQ_HATCH_PARTY"]]
+    split = [op for op, a in steps].index("NEXT") + 1
+    outer = self.t.label
+    self.keep = True
+    self.t.label = "hatch/walk"
+    self.play(steps[:split] + [("RETURN", [])])
+    self.t.label = "hatch/dialogue"
+    self.play(steps[split:])
+    self.keep = False
+    self.t.label = outer
+
+  def releaseBoxes(self, boxes):
+    self.setPhase("release")
+    self.openBox("SEQ_OPEN_BOX_NORMAL", "BOX_NORMAL")
+    rows, cols = self.c["BOX_ROWS"], self.c["BOX_COLUMNS"]
+    for box in range(boxes):
+      for i in range(cols):
+        col = cols - 1 - i if box & 1 else i
+        for j in range(rows):
+          self.releaseStart(rows - 1 - j if i & 1 else j, col)
+          self.saveCheckpoint(CHECKPOINT_RELEASE, i * rows + j + 1, box, 0)
+          self.releaseEnd()
+      if box + 1 < boxes:
+        self.nextBox()
+        self.saveCheckpoint(CHECKPOINT_RELEASE, 0, box + 1, 0)
+    self.runId("SEQ_CLOSE_MENUS")
+
+  def main(self):
+    mode = self.s["mode"]
+    self.var["VAR_COLLECT_PASSES"] = self.s["collectPasses"]
+    self.var["VAR_HATCH_PASSES"] = self.hatchPasses()
+    self.pair()
+    if mode in ("COLLECTING", "COLLECT_THEN_HATCH", "COLLECT_AND_HATCH"):
+      self.setPhase("collect")
+      self.run("enterBridge", "walk", True)
+    if mode == "HATCHING":
+      for box in range(min(self.s["boxesToHatch"], len(self.boxMap))):
+        self.boxMap[box] |= self.s["hatchColumns"]
+    if mode in ("COLLECTING", "COLLECT_THEN_HATCH"):
+      self.setPhase("collect")
+      for i in range(self.s["eggsToCollect"]):
+        self.collect()
+        self.saveCheckpoint(CHECKPOINT_COLLECT, i + 1, 0, self.var["VAR_ROW"])
+      if self.var["VAR_ROW"] > 0:
+        self.storeParty()
+        self.saveCheckpoint(CHECKPOINT_COLLECT, self.s["eggsToCollect"], 0, 0)
+    if mode == "COLLECT_AND_HATCH":
+      self.setPhase("collect")
+      self.var["VAR_COLLECT_PASSES"] = self.pipelinePasses()
+      for i in range(self.s["eggsToCollect"]):
+        self.run("walkAndHatch", "walk", True)
+        if i < self.c["PARTY_EGGS"]:
+          self.run("takeEgg", "day care")
+        else:
+          self.var["VAR_PARTY_SLOT"] = 1 + i % self.c["PARTY_EGGS"]
+          self.run("swapEgg", "day care")
+        self.saveCheckpoint(CHECKPOINT_PIPELINE, i + 1, 0, 0)
+      self.setPhase("hatch")
+      self.var["VAR_PARTY_EGGS"] = min(self.s["eggsToCollect"], self.c["PARTY_EGGS"])
+      self.runHatchParty()
+    if mode == "COLLECT_THEN_HATCH":
+      self.setPhase("return")
+      self.openBox()
+      for _ in range(self.var["VAR_BOXES_FORWARD"]):
+        self.prevBox()
+      self.runId("SEQ_CLOSE_MENUS")
+      self.saveCheckpoint(CHECKPOINT_HATCH_START, 0, 0, 0)
+    if mode in ("COLLECT_THEN_HATCH", "HATCHING"):
+      self.hatch()
+    if mode == "RELEASING":
+      self.releaseBoxes(self.s["numBoxes"])
+    self.saveCheckpoint(CHECKPOINT_NONE, 0, 0, 0)
+    self.setPhase("end", "flush")
+    self.t.sync()
+    return self.t.frame()
+
+# ---------------------------------------------------------------------------
+
+def hours(ms):
+  return ms / 3600000.0
+
+def clock(ms):
+  s = ms // 1000
+  return "{}:{:02}:{:02}".format(s // 3600, s // 60 % 60, s % 60)
+
+def report(job, frames):
+  s, t, c = job.s, job.t, job.c
+  mode = s["mode"]
+  if mode == "RELEASING":
+    units = [("box", s["numBoxes"]), ("pokemon", s["numBoxes"] * c["BOX_ROWS"] * c["BOX_COLUMNS"])]
+  else:
+    if mode == "HATCHING":
+      columns = bin(s["hatchColumns"] & 0x3F).count("1") * min(s["boxesToHatch"], c["MAP_BOXES"])
+      eggs = columns * c["BOX_ROWS"]
+    else:
+      eggs = s["eggsToCollect"]
+      columns = -(-eggs // c["BOX_ROWS"])
+    units = [("box", columns / float(c["BOX_COLUMNS"])), ("column", columns), ("egg", eggs)]
+
+  print("{} job, poll {}ms, {} reports, {}".format(mode, t.poll, frames // t.poll, clock(frames)))
+  for name, count in units:
+    if count:
+      print("  per {:<8} {:>9.1f}s  {:>8} reports".format(name, frames / 1000.0 / count, int(frames // t.poll / count)))
+  perHour = units[-1][1] / hours(frames) if frames else 0
+  print("  {:.1f} {} per hour".format(perHour, "released" if mode == "RELEASING" else "eggs"))
+  print("")
+  total = float(sum(t.costs.values()))
+  for label, ms in sorted(t.costs.items(), key=lambda item: -item[1]):
+    if ms:
+      print("  {:<24} {:>9.1f}s  {:5.1f}%  {:>8} reports".format(label, ms / 1000.0, 100 * ms / total, ms // t.poll))
+
+def main(argv):
+  opts, args = getopt.getopt(argv, "hm:e:b:n:c:p:y:f:r:k:l:i:s:t")
+
+  sourceDir = os.path.dirname(os.path.abspath(__file__))
+  poll = None
+  timeline = False
+  overrides = {}
+  for opt, arg in opts:
+    if opt == '-h':
+      usage()
+      sys.exit()
+    elif opt == '-m':
+      if arg not in MODES:
+        print("ERROR: Unknown mode " + arg)
+        sys.exit(1)
+      overrides["mode"] = arg
+    elif opt == '-k':
+      overrides["keepSlots"] = [int(v, 0) for v in arg.split(",")]
+    elif opt == '-i':
+      poll = int(arg, 0)
+    elif opt == '-s':
+      sourceDir = arg
+    elif opt == '-t':
+      timeline = True
+    else:
+      names = {"-e": "eggsToCollect", "-b": "boxesToHatch", "-n": "numBoxes", "-c": "collectPasses",
+          "-p": "hatchPasses", "-y": "eggCycles", "-f": "flameBody", "-r": "releaseHatched", "-l": "hatchColumns"}
+      overrides[names[opt]] = int(arg, 0)
+
+  texts = [readSource(os.path.join(sourceDir, name))
+      for name in ["Joystick.h", "Sequence.h", "Box.h", "Settings.h", "Joystick.c"]]
+  c = readConstants(texts)
+  sequences, table = readSequences(texts[-1], c)
+  settings = {
+    "mode": "HATCHING",
+    "eggsToCollect": c["DEFAULT_EGGS"],
+    "boxesToHatch": c["DEFAULT_BOXES"],
+    "numBoxes": c["DEFAULT_RELEASE_BOXES"],
+    "collectPasses": c["DEFAULT_COLLECT_PASSES"],
+    "hatchPasses": c["DEFAULT_HATCH_PASSES"],
+    "eggCycles": c["DEFAULT_CYCLES"],
+    "flameBody": c["DEFAULT_FLAME_BODY"],
+    "releaseHatched": c["DEFAULT_RELEASE_HATCHED"],
+    "keepSlots": [0] * c["BOX_COLUMNS"],
+    "hatchColumns": c["DEFAULT_HATCH_COLUMNS"],
+  }
+  settings.update(overrides)
+
+  job = Job(c, sequences, table, settings, poll or c["DEFAULT_POLL_MS"])
+  frames = job.main()
+  if timeline:
+    # As written by the host build's -c option.
+    for cp in job.checkpoints:
+      print("{} {} {} {} {}".format(*cp))
+    print("frames {}".format(frames))
+    return
+  report(job, frames)
+
+def usage():
+  print("To cost a job from the sequence tables: seqcost.py [options]")
+  print("  -m mode, -e, -b, -n, -c, -p, -y, -f, -r, -k, -l")
+  print("                 the job, as for eepconfig.py (default the built-in defaults)")
+  print("  -i ms          poll interval of the host (default DEFAULT_POLL_MS)")
+  print("  -s dir         source to read (default the directory of seqcost.py)")
+  print("  -t             print the checkpoints instead, as the host build's -c does")
+  print("Prints the time and reports per egg, column, box and job, eggs per hour, and")
+  print("where the time goes, ranked. Pairing is costed as with a host that sends no")
+  print("OUT reports, and EEPROM writes as taking no time, as in the host build.")
+
+if __name__ == "__main__":
+  main(sys.argv[1:])